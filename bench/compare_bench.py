@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+"""Compare two sgp4_bench result files, baseline against candidate.
+
+For every benchmark in both files the speedup is the baseline time per
+operation over the candidate's, so above 1 the candidate is faster. Its
+confidence interval is bootstrapped from the repetition samples of the two
+runs, with a fixed seed so a comparison is reproducible.
+
+A benchmark regresses when the whole interval lies below 1 - threshold,
+i.e. the candidate is slower by more than the threshold with the given
+confidence. The exit status is 1 if any gated benchmark regresses, 2 if
+the input cannot be read, and 0 otherwise.
+
+Benchmarks are named function/regime, as sgp4_bench writes them, e.g.
+FindPosition/near_earth. Gates are shell patterns over those names, and
+the summary gives the geometric mean speedup per orbit regime.
+
+usage: compare_bench.py baseline.json candidate.json
+           [--threshold 0.05] [--confidence 0.95]
+           [--gate 'FindPosition/*' --gate 'Observer/*' ...]
+"""
+
+import argparse
+import fnmatch
+import json
+import math
+import random
+import sys
+
+# bootstrap resamples per benchmark
+RESAMPLES = 5000
+SEED = 12345
+
+
+def load(filename):
+    with open(filename) as f:
+        data = json.load(f)
+    benchmarks = {}
+    for b in data['benchmarks']:
+        samples = b.get('samples') or [b['ns_per_op']]
+        benchmarks[b['name']] = {
+            'regime': b.get('regime', ''),
+            'samples': samples,
+        }
+    return data.get('context', {}), benchmarks
+
+
+def mean(values):
+    return sum(values) / len(values)
+
+
+def speedup_interval(baseline, candidate, confidence, rng):
+    """Percentile bootstrap interval of mean(baseline) / mean(candidate)."""
+    estimate = mean(baseline) / mean(candidate)
+    if len(baseline) < 2 and len(candidate) < 2:
+        return estimate, estimate, estimate
+
+    ratios = []
+    for _ in range(RESAMPLES):
+        b = [rng.choice(baseline) for _ in baseline]
+        c = [rng.choice(candidate) for _ in candidate]
+        ratios.append(mean(b) / mean(c))
+    ratios.sort()
+    tail = (1.0 - confidence) / 2.0
+    low = ratios[int(math.floor(tail * (RESAMPLES - 1)))]
+    high = ratios[int(math.ceil((1.0 - tail) * (RESAMPLES - 1)))]
+    return estimate, low, high
+
+
+def gated(name, patterns):
+    return any(fnmatch.fnmatchcase(name, p) for p in patterns)
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Compare two sgp4_bench result files.')
+    parser.add_argument('baseline')
+    parser.add_argument('candidate')
+    parser.add_argument('--threshold', type=float, default=0.05,
+                        help='largest tolerated slowdown, as a fraction '
+                             '(default 0.05)')
+    parser.add_argument('--confidence', type=float, default=0.95,
+                        help='confidence of the speedup intervals '
+                             '(default 0.95)')
+    parser.add_argument('--gate', action='append',
+                        help='pattern of the benchmark names that fail the '
+                             'comparison when they regress; may be repeated '
+                             '(default all)')
+    args = parser.parse_args()
+
+    try:
+        baseline_context, baseline = load(args.baseline)
+        candidate_context, candidate = load(args.candidate)
+    except (OSError, ValueError, KeyError) as e:
+        print('Failed to read benchmark results: %s' % e, file=sys.stderr)
+        return 2
+
+    for context in (baseline_context, candidate_context):
+        if context.get('build_type') not in ('Release', 'RelWithDebInfo'):
+            print('Warning: results from a build that is not optimised',
+                  file=sys.stderr)
+            break
+
+    patterns = args.gate or ['*']
+    rng = random.Random(SEED)
+    regressions = []
+    by_regime = {}
+
+    print('%-36s %12s %12s %8s  %-17s' % (
+        'benchmark', 'base ns/op', 'cand ns/op', 'speedup',
+        '%g%% interval' % (100 * args.confidence)))
+    for name in sorted(set(baseline) | set(candidate)):
+        if name not in candidate:
+            print('%-36s removed' % name)
+            continue
+        if name not in baseline:
+            print('%-36s added' % name)
+            continue
+
+        b = baseline[name]['samples']
+        c = candidate[name]['samples']
+        estimate, low, high = speedup_interval(b, c, args.confidence, rng)
+
+        regressed = high < 1.0 - args.threshold
+        mark = ''
+        if regressed and gated(name, patterns):
+            regressions.append(name)
+            mark = '  REGRESSION'
+        elif regressed:
+            mark = '  slower'
+        elif low > 1.0 + args.threshold:
+            mark = '  faster'
+
+        print('%-36s %12.1f %12.1f %8.3f  [%6.3f, %6.3f]%s' % (
+            name, mean(b), mean(c), estimate, low, high, mark))
+
+        regime = baseline[name]['regime'] or 'general'
+        by_regime.setdefault(regime, []).append(estimate)
+
+    print()
+    for regime in sorted(by_regime):
+        speedups = by_regime[regime]
+        geomean = math.exp(sum(math.log(s) for s in speedups) / len(speedups))
+        print('%-12s geometric mean speedup %.3f over %d benchmarks' % (
+            regime, geomean, len(speedups)))
+
+    if regressions:
+        print('\n%d benchmarks regressed by more than %g%%: %s' % (
+            len(regressions), 100 * args.threshold, ', '.join(regressions)))
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
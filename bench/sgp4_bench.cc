@@ -0,0 +1,605 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <CoordGeodetic.h>
+#include <CoordTopocentric.h>
+#include <DateTime.h>
+#include <Eci.h>
+#include <Instrumentation.h>
+#include <Observer.h>
+#include <OrbitalElements.h>
+#include <SGP4.h>
+#include <SatelliteCatalog.h>
+#include <SolarPosition.h>
+#include <Tle.h>
+#include <Util.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Microbenchmarks for the hot paths of libsgp4.
+ *
+ * Each benchmark is warmed up for the minimum time, which also sets the
+ * number of operations per repetition, and then timed over a number of
+ * repetitions. The time per operation of every repetition is kept as a
+ * sample, so results can be compared statistically.
+ *
+ * Benchmarks are named function/regime, the regime being near_earth or
+ * deep_space where the orbit matters and omitted otherwise. Orbits come from
+ * SGP4-VER.TLE, split by period the same way SGP4 does.
+ *
+ * usage: sgp4_bench [--tle file] [--out file] [--repetitions n]
+ *                   [--min-time seconds] [--filter substring]
+ */
+
+#ifndef SGP4_BENCH_BUILD_TYPE
+#define SGP4_BENCH_BUILD_TYPE ""
+#endif
+
+namespace
+{
+
+struct Options
+{
+   std::string tle_file = "SGP4-VER.TLE";
+   std::string out_file;
+   int repetitions = 10;
+   double min_time = 0.05;
+   std::string filter;
+};
+
+struct Result
+{
+   std::string name;
+   std::string function;
+   std::string regime;
+   uint64_t iterations;
+   std::vector<double> samples;
+};
+
+struct Orbit
+{
+   libsgp4::Tle tle;
+   std::string line1;
+   std::string line2;
+   bool deep_space;
+};
+
+/*
+ * results are summed into a volatile so the work cannot be optimised away
+ */
+volatile double g_sink;
+
+typedef std::chrono::steady_clock Clock;
+
+double Seconds( const Clock::time_point& start )
+{
+   return std::chrono::duration<double>( Clock::now() - start ).count();
+}
+
+/*
+ * time op, which does batch operations per call, so batched functions are
+ * reported per operation like the rest
+ */
+template <typename Op>
+Result Run( const Options& options,
+            const std::string& function,
+            const std::string& regime,
+            Op op,
+            const uint64_t batch = 1 )
+{
+   Result result;
+   result.function = function;
+   result.regime = regime;
+   result.name = regime.empty() ? function : function + "/" + regime;
+
+   /*
+    * warm up for the minimum time; the operations done in it set the
+    * number per repetition
+    */
+   double sink = 0.0;
+   uint64_t count = 0;
+   const Clock::time_point warm_up = Clock::now();
+   do
+   {
+      sink += op( count++ );
+   }
+   while ( Seconds( warm_up ) < options.min_time );
+   result.iterations = count;
+
+   for ( int r = 0; r < options.repetitions; r++ )
+   {
+      const Clock::time_point start = Clock::now();
+      for ( uint64_t i = 0; i < count; i++ )
+      {
+         sink += op( i );
+      }
+      result.samples.push_back( Seconds( start ) * 1e9 / static_cast<double>( count * batch ) );
+   }
+
+   g_sink = sink;
+   return result;
+}
+
+double Mean( const std::vector<double>& samples )
+{
+   double sum = 0.0;
+   for ( double s : samples )
+   {
+      sum += s;
+   }
+   return sum / static_cast<double>( samples.size() );
+}
+
+double StdDev( const std::vector<double>& samples )
+{
+   if ( samples.size() < 2 )
+   {
+      return 0.0;
+   }
+   const double mean = Mean( samples );
+   double sum = 0.0;
+   for ( double s : samples )
+   {
+      sum += ( s - mean ) * ( s - mean );
+   }
+   return std::sqrt( sum / static_cast<double>( samples.size() - 1 ) );
+}
+
+double Median( std::vector<double> samples )
+{
+   std::sort( samples.begin(), samples.end() );
+   const size_t n = samples.size();
+   return n % 2 == 1 ? samples[n / 2]
+          : 0.5 * ( samples[n / 2 - 1] + samples[n / 2] );
+}
+
+/*
+ * read the element sets of SGP4-VER.TLE, skipping comments and any the
+ * propagator rejects
+ */
+std::vector<Orbit> ReadOrbits( const std::string& filename )
+{
+   std::vector<Orbit> orbits;
+   std::ifstream file( filename );
+   std::string line;
+   std::string line1;
+
+   while ( std::getline( file, line ) )
+   {
+      libsgp4::Util::Trim( line );
+      if ( line.length() < libsgp4::Tle::LineLength() || line[0] == '#' )
+      {
+         line1.clear();
+         continue;
+      }
+      if ( line[0] == '1' )
+      {
+         line1 = line.substr( 0, libsgp4::Tle::LineLength() );
+         continue;
+      }
+      if ( line[0] != '2' || line1.empty() )
+      {
+         continue;
+      }
+
+      const std::string line2 = line.substr( 0, libsgp4::Tle::LineLength() );
+      try
+      {
+         libsgp4::Tle tle( "Test", line1, line2 );
+         libsgp4::SGP4 sgp4( tle );
+         const bool deep_space = libsgp4::OrbitalElements( tle ).Period() >= 225.0;
+         orbits.push_back( { tle, line1, line2, deep_space } );
+      }
+      catch ( std::exception& )
+      {
+      }
+      line1.clear();
+   }
+
+   return orbits;
+}
+
+/*
+ * a day of positions every 10 minutes for each orbit of a regime, keeping
+ * only those the propagator returns without an exception
+ */
+void BuildCases( const std::vector<libsgp4::SGP4>& propagators,
+                 std::vector<std::pair<size_t, double>>& cases,
+                 std::vector<libsgp4::Eci>& positions )
+{
+   for ( size_t i = 0; i < propagators.size(); i++ )
+   {
+      for ( double tsince = 0.0; tsince <= 1440.0; tsince += 10.0 )
+      {
+         try
+         {
+            positions.push_back( propagators[i].FindPosition( tsince ) );
+            cases.emplace_back( i, tsince );
+         }
+         catch ( std::exception& )
+         {
+            break;
+         }
+      }
+   }
+}
+
+void WriteJson( std::ostream& os, const std::vector<Result>& results,
+                const Options& options )
+{
+   const std::time_t now = std::time( nullptr );
+   char date[32];
+   std::strftime( date, sizeof( date ), "%Y-%m-%dT%H:%M:%SZ", std::gmtime( &now ) );
+
+   os << std::setprecision( 6 ) << std::fixed;
+   os << "{\n";
+   os << "  \"context\": {\n";
+   os << "    \"date\": \"" << date << "\",\n";
+#ifdef __VERSION__
+   os << "    \"compiler\": \"" << __VERSION__ << "\",\n";
+#endif
+   os << "    \"build_type\": \"" << SGP4_BENCH_BUILD_TYPE << "\",\n";
+   os << "    \"repetitions\": " << options.repetitions << ",\n";
+   os << "    \"min_time\": " << options.min_time << "\n";
+   os << "  },\n";
+   os << "  \"benchmarks\": [";
+
+   for ( size_t i = 0; i < results.size(); i++ )
+   {
+      const Result& r = results[i];
+      const double mean = Mean( r.samples );
+      os << ( i == 0 ? "\n" : ",\n" );
+      os << "    {\n";
+      os << "      \"name\": \"" << r.name << "\",\n";
+      os << "      \"function\": \"" << r.function << "\",\n";
+      os << "      \"regime\": \"" << r.regime << "\",\n";
+      os << "      \"iterations\": " << r.iterations << ",\n";
+      os << "      \"ns_per_op\": " << mean << ",\n";
+      os << "      \"ns_per_op_median\": " << Median( r.samples ) << ",\n";
+      os << "      \"ns_per_op_stddev\": " << StdDev( r.samples ) << ",\n";
+      os << "      \"ns_per_op_min\": "
+         << *std::min_element( r.samples.begin(), r.samples.end() ) << ",\n";
+      os << "      \"ns_per_op_max\": "
+         << *std::max_element( r.samples.begin(), r.samples.end() ) << ",\n";
+      os << "      \"ops_per_sec\": " << 1e9 / mean << ",\n";
+      os << "      \"samples\": [";
+      for ( size_t s = 0; s < r.samples.size(); s++ )
+      {
+         os << ( s == 0 ? "" : ", " ) << r.samples[s];
+      }
+      os << "]\n";
+      os << "    }";
+   }
+
+   os << "\n  ]\n";
+   os << "}\n";
+}
+
+bool ParseOptions( int argc, char* argv[], Options& options )
+{
+   for ( int i = 1; i < argc; i++ )
+   {
+      const std::string arg = argv[i];
+      if ( i + 1 >= argc )
+      {
+         return false;
+      }
+      const std::string value = argv[++i];
+      if ( arg == "--tle" )
+      {
+         options.tle_file = value;
+      }
+      else if ( arg == "--out" )
+      {
+         options.out_file = value;
+      }
+      else if ( arg == "--repetitions" )
+      {
+         options.repetitions = std::max( std::atoi( value.c_str() ), 1 );
+      }
+      else if ( arg == "--min-time" )
+      {
+         options.min_time = std::atof( value.c_str() );
+      }
+      else if ( arg == "--filter" )
+      {
+         options.filter = value;
+      }
+      else
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+   Options options;
+   if ( !ParseOptions( argc, argv, options ) )
+   {
+      std::cerr << "usage: sgp4_bench [--tle file] [--out file] "
+                << "[--repetitions n] [--min-time seconds] "
+                << "[--filter substring]" << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   const std::string build_type = SGP4_BENCH_BUILD_TYPE;
+   if ( build_type != "Release" && build_type != "RelWithDebInfo" )
+   {
+      std::cerr << "Warning: not an optimised build, configure with "
+                << "-DCMAKE_BUILD_TYPE=Release" << std::endl;
+   }
+
+   const std::vector<Orbit> orbits = ReadOrbits( options.tle_file );
+   if ( orbits.empty() )
+   {
+      std::cerr << "No element sets in " << options.tle_file << std::endl;
+      return EXIT_FAILURE;
+   }
+
+   /*
+    * per regime: element sets, propagators and propagation cases
+    */
+   const char* const regimes[] = { "near_earth", "deep_space" };
+   std::vector<libsgp4::Tle> tles[2];
+   std::vector<libsgp4::SGP4> propagators[2];
+   std::vector<std::pair<size_t, double>> cases[2];
+   std::vector<libsgp4::Eci> positions[2];
+   for ( const auto& orbit : orbits )
+   {
+      const int r = orbit.deep_space ? 1 : 0;
+      tles[r].push_back( orbit.tle );
+      propagators[r].emplace_back( orbit.tle );
+   }
+   for ( int r = 0; r < 2; r++ )
+   {
+      BuildCases( propagators[r], cases[r], positions[r] );
+   }
+
+   std::vector<libsgp4::DateTime> dates;
+   for ( const auto& eci : positions[0] )
+   {
+      dates.push_back( eci.GetDateTime() );
+   }
+
+   std::vector<Result> results;
+   auto selected = [&options]( const std::string& name )
+   {
+      return options.filter.empty() || name.find( options.filter ) != std::string::npos;
+   };
+
+   if ( selected( "Tle/construct" ) )
+   {
+      results.push_back( Run( options, "Tle/construct", "", [&]( uint64_t i )
+      {
+         const Orbit& orbit = orbits[i % orbits.size()];
+         libsgp4::Tle tle( "Test", orbit.line1, orbit.line2 );
+         return tle.MeanMotion();
+      } ) );
+   }
+
+   if ( selected( "OrbitalElements/construct" ) )
+   {
+      results.push_back( Run( options, "OrbitalElements/construct", "", [&]( uint64_t i )
+      {
+         libsgp4::OrbitalElements elements( orbits[i % orbits.size()].tle );
+         return elements.Period();
+      } ) );
+   }
+
+   /*
+    * a fresh catalog per call, of the element sets repeated to the size of
+    * a small catalog, reported per element set; construction alone is what
+    * a run that propagates few objects pays up front
+    */
+   std::vector<libsgp4::Tle> catalog_tles;
+   while ( catalog_tles.size() < 4096 )
+   {
+      catalog_tles.push_back( orbits[catalog_tles.size() % orbits.size()].tle );
+   }
+   if ( selected( "SatelliteCatalog/construct" ) )
+   {
+      results.push_back( Run( options, "SatelliteCatalog/construct", "", [&]( uint64_t )
+      {
+         libsgp4::SatelliteCatalog catalog( catalog_tles );
+         return static_cast<double>( catalog.Size() );
+      }, catalog_tles.size() ) );
+   }
+   for ( const unsigned int threads : { 1U, 0U } )
+   {
+      const std::string regime = threads == 1 ? "serial" : "parallel";
+      if ( selected( "SatelliteCatalog/InitialiseAll/" + regime ) )
+      {
+         results.push_back( Run( options, "SatelliteCatalog/InitialiseAll", regime, [&]( uint64_t )
+         {
+            libsgp4::SatelliteCatalog catalog( catalog_tles );
+            return static_cast<double>( catalog.InitialiseAll( threads ) );
+         }, catalog_tles.size() ) );
+      }
+   }
+
+   for ( int r = 0; r < 2; r++ )
+   {
+      if ( tles[r].empty() )
+      {
+         continue;
+      }
+
+      /*
+       * SetTle is the public way to run Initialise; it includes rebuilding
+       * the OrbitalElements
+       */
+      if ( selected( std::string( "SGP4/Initialise/" ) + regimes[r] ) )
+      {
+         results.push_back( Run( options, "SGP4/Initialise", regimes[r], [&]( uint64_t i )
+         {
+            const size_t k = i % tles[r].size();
+            propagators[r][k].SetTle( tles[r][k] );
+            return 0.0;
+         } ) );
+      }
+
+      /*
+       * RestoreState with a state saved earlier, also rebuilding the
+       * OrbitalElements, so it compares with SGP4/Initialise; the states
+       * are restored into a scratch propagator, leaving the shared ones
+       * for the benches after this one
+       */
+      if ( selected( std::string( "SGP4/RestoreState/" ) + regimes[r] ) )
+      {
+         std::vector<std::vector<char>> states;
+         for ( const libsgp4::SGP4& propagator : propagators[r] )
+         {
+            states.push_back( propagator.SaveState() );
+         }
+         libsgp4::SGP4 scratch( propagators[r].back() );
+         results.push_back( Run( options, "SGP4/RestoreState", regimes[r], [&]( uint64_t i )
+         {
+            const size_t k = i % tles[r].size();
+            return scratch.RestoreState( tles[r][k], states[k] ) ? 0.0 : 1.0;
+         } ) );
+      }
+
+      if ( selected( std::string( "FindPosition/" ) + regimes[r] ) )
+      {
+         results.push_back( Run( options, "FindPosition", regimes[r], [&]( uint64_t i )
+         {
+            const std::pair<size_t, double>& c = cases[r][i % cases[r].size()];
+            return propagators[r][c.first].FindPosition( c.second ).Position().x;
+         } ) );
+      }
+
+      if ( selected( std::string( "FindPositions/" ) + regimes[r] ) )
+      {
+         /*
+          * each batch spreads evenly from epoch to the time of a case, over
+          * which the propagator is known to succeed
+          */
+         const size_t kBatch = 64;
+         std::vector<double> times( kBatch );
+         libsgp4::PositionBuffer buffer;
+         results.push_back( Run( options, "FindPositions", regimes[r], [&]( uint64_t i )
+         {
+            const size_t first = ( i * kBatch ) % cases[r].size();
+            const size_t orbit = cases[r][first].first;
+            for ( size_t k = 0; k < kBatch; k++ )
+            {
+               times[k] = cases[r][first].second * static_cast<double>( k + 1 ) / kBatch;
+            }
+            propagators[r][orbit].FindPositions( times.data(), kBatch, buffer );
+            return buffer.Data( libsgp4::PositionBuffer::X )[kBatch - 1];
+         }, kBatch ) );
+      }
+
+      /*
+       * the single precision kernel only covers near earth orbits
+       */
+      if ( r == 0 && selected( std::string( "FindPositionFloat/" ) + regimes[r] ) )
+      {
+         results.push_back( Run( options, "FindPositionFloat", regimes[r], [&]( uint64_t i )
+         {
+            const std::pair<size_t, double>& c = cases[r][i % cases[r].size()];
+            return static_cast<double>( propagators[r][c.first].FindPositionFloat( c.second ).position[0] );
+         } ) );
+      }
+   }
+
+   if ( !positions[0].empty() )
+   {
+      libsgp4::Observer observer( libsgp4::CoordGeodetic( 51.507406923983446,
+                                  -0.12773752212524414, 0.05 ) );
+
+      if ( selected( "Observer/GetLookAngle" ) )
+      {
+         results.push_back( Run( options, "Observer/GetLookAngle", "", [&]( uint64_t i )
+         {
+            return observer.GetLookAngle( positions[0][i % positions[0].size()] ).m_elevation;
+         } ) );
+      }
+
+      if ( selected( "Eci/ToGeodetic" ) )
+      {
+         results.push_back( Run( options, "Eci/ToGeodetic", "", [&]( uint64_t i )
+         {
+            return positions[0][i % positions[0].size()].ToGeodetic().m_latitude;
+         } ) );
+      }
+
+      if ( selected( "DateTime/ToGreenwichSiderealTime" ) )
+      {
+         results.push_back( Run( options, "DateTime/ToGreenwichSiderealTime", "", [&]( uint64_t i )
+         {
+            return dates[i % dates.size()].ToGreenwichSiderealTime();
+         } ) );
+      }
+
+      if ( selected( "SolarPosition/FindPosition" ) )
+      {
+         libsgp4::SolarPosition solar;
+         results.push_back( Run( options, "SolarPosition/FindPosition", "", [&]( uint64_t i )
+         {
+            return solar.FindPosition( dates[i % dates.size()] ).Position().x;
+         } ) );
+      }
+   }
+
+   for ( const auto& r : results )
+   {
+      const double mean = Mean( r.samples );
+      std::cerr << std::left << std::setw( 36 ) << r.name << std::right
+                << std::fixed << std::setprecision( 1 )
+                << std::setw( 12 ) << mean << " ns/op"
+                << std::setw( 14 ) << std::setprecision( 0 ) << 1e9 / mean << " ops/s"
+                << "  +/- " << std::setprecision( 1 )
+                << 100.0 * StdDev( r.samples ) / mean << "%" << std::endl;
+   }
+
+   /*
+    * an instrumented library also reports the work the benchmarks did
+    */
+   if ( libsgp4::Instrumentation::kEnabled )
+   {
+      std::cerr << libsgp4::Instrumentation::Snapshot().ToString();
+   }
+
+   if ( options.out_file.empty() )
+   {
+      WriteJson( std::cout, results, options );
+   }
+   else
+   {
+      std::ofstream out( options.out_file );
+      WriteJson( out, results, options );
+   }
+
+   return EXIT_SUCCESS;
+}
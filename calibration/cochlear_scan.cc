@@ -3,61 +3,44 @@
 #include <iostream>
 #include <vector>
 
-struct Point {
-  double x, y;
-};
+#include <DateTime.h>
+#include <PointingCommand.h>
+#include <ScanPattern.h>
+#include <Util.h>
 
 /**
- * @param r_max Initial (maximum) radius.
- * @param r_min Minimum radius to stop at.
- * @param s Constant arc length between points.
+ * @param r_max Initial (maximum) radius, degrees.
+ * @param r_min Minimum radius to stop at, degrees.
+ * @param s Constant arc length between points, degrees.
  * @param num_turns Number of spiral turns
- * @return Vector of points along the spiral.
+ * @return The scan offsets, one per point, with the cross-elevation in
+ * azimuth and the elevation offset in elevation (radians).
  */
-std::vector<Point> generate_cochlear_scan(double r_max, double r_min, double s,
-                                          double num_turns) {
-  std::vector<Point> points;
+std::vector<libsgp4::PointingCommand>
+generate_cochlear_scan(double r_max, double r_min, double s, double num_turns) {
+  std::vector<libsgp4::PointingCommand> points;
   if (r_max <= r_min || s <= 0 || num_turns <= 0) {
     std::cerr << "SOmeThinG is WrOnG." << std::endl;
     return points; // Invalid parameters
   }
 
-  // Compute k based on number of turns: theta_max = num_turns * 2 * PI
-  double theta_max = num_turns * 2.0 * M_PI;
-  // double k = std::log(r_max / r_min) / theta_max;
-  double a = (r_max - r_min) / theta_max;
+  // One point per second at a speed of s per second puts the points exactly
+  // s apart along the spiral.
+  libsgp4::ScanParameters parameters;
+  parameters.type = libsgp4::ScanType::SPIRAL;
+  parameters.radius = libsgp4::Util::DegreesToRadians(r_max);
+  parameters.inner_radius = libsgp4::Util::DegreesToRadians(r_min);
+  parameters.spacing = libsgp4::Util::DegreesToRadians((r_max - r_min) / num_turns);
+  parameters.speed = libsgp4::Util::DegreesToRadians(s);
 
-  double theta = 0.0;
-  double r = r_max;
+  libsgp4::ScanPattern scan(parameters);
+  scan.Start(libsgp4::DateTime::Now(true), 1.0);
 
-  std::ofstream ofs;
-  ofs.open("cochlear.csv");
-  size_t iterations{0};
-  while (r > r_min) {
-    double x = r * std::cos(theta);
-    double y = r * std::sin(theta);
-    points.push_back({x, y});
-
-    ofs << theta << "," << r << "\n";
-    // ofs << theta << "," << r << "," << x << "," << y << "\n";
-    // std::cout << theta << "," << r << "," << x << "," << y << "\n";
-
-    // Approximate delta_theta for constant arc length s (ignoring radial
-    // component for simplicity)
-    double delta_theta = s / r;
-
-    // Update theta and recompute r
-    theta += delta_theta;
-    // r = r_max * std::exp(-k * theta);
-    r = r_max - a * theta;
-
-    if (r < r_min) {
-      r = r_min;
-    }
-    iterations++;
-  }
-  std::cout << "Iterations:(" << iterations << ")\n";
+  // the whole scan fits one preallocated buffer
+  points.resize(static_cast<size_t>(scan.Duration()) + 1);
+  points.resize(scan.Fill(points.data(), points.size()));
 
+  std::cout << "Iterations:(" << points.size() << ")\n";
   return points;
 }
 
@@ -70,5 +53,13 @@ int main() {
       5.0; // This will give an inter-scan spacing of 0.1 of a degree.
 
   auto points = generate_cochlear_scan(r_max, r_min, s, num_turns);
+
+  // theta (radians) and r (degrees), as plot_cochlear.py expects
+  std::ofstream ofs("cochlear.csv");
+  for (const auto &p : points) {
+    ofs << std::atan2(p.elevation, p.azimuth) << ","
+        << libsgp4::Util::RadiansToDegrees(std::hypot(p.azimuth, p.elevation))
+        << "\n";
+  }
   return 0;
 }
@@ -0,0 +1,83 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <CoordGeodetic.h>
+#include <DateTime.h>
+#include <PassPredictor.h>
+#include <PointingCommand.h>
+#include <SGP4.h>
+#include <ScanPattern.h>
+#include <TrajectoryGenerator.h>
+#include <Util.h>
+
+// Conical scan around the predicted track of the next pass of a craft: one
+// circle of the given radius, superimposed on the track at controller rate.
+// The commands are streamed in controller sized blocks from a fixed buffer
+// and written to conical.csv as time, az, el (degrees).
+
+// commands handed to the controller at a time
+static const size_t kBlockSize = 100;
+
+int main(int argc, char *argv[]) {
+  // usage: conical_scan [tle file] [radius deg] [speed deg/s] [rate Hz]
+  std::string tle_filename = argc > 1 ? argv[1] : "../visible_craft/mPOWER.tle";
+  double radius = argc > 2 ? std::atof(argv[2]) : 0.25;
+  double speed = argc > 3 ? std::atof(argv[3]) : 0.5;
+  double rate = argc > 4 ? std::atof(argv[4]) : 50.0;
+
+  std::ifstream infile(tle_filename);
+  std::string name, line1, line2;
+  if (!std::getline(infile, name) || !std::getline(infile, line1) ||
+      !std::getline(infile, line2)) {
+    std::cout << "Failed to read TLE File." << std::endl;
+    return -EXIT_FAILURE;
+  }
+
+  libsgp4::Tle tle(name, line1, line2);
+  libsgp4::SGP4 sgp4(tle);
+
+  // lat/lon/altitude of PIE airport.
+  libsgp4::CoordGeodetic observer_GPS(27.9086, -82.6865, 3.0);
+
+  libsgp4::PassPredictor predictor(observer_GPS, sgp4);
+  libsgp4::DateTime now = libsgp4::DateTime::Now(true);
+  std::list<libsgp4::PassDetails> passes =
+      predictor.GeneratePassList(now, now.AddDays(1.0), 60);
+  if (passes.empty()) {
+    std::cout << "No pass of " << tle.Name() << " within a day." << std::endl;
+    return 0;
+  }
+
+  libsgp4::ScanParameters parameters;
+  parameters.type = libsgp4::ScanType::CONICAL;
+  parameters.radius = libsgp4::Util::DegreesToRadians(radius);
+  parameters.speed = libsgp4::Util::DegreesToRadians(speed);
+  libsgp4::ScanPattern scan(parameters);
+
+  // scan from the culmination of the pass
+  const libsgp4::PassDetails &pass = passes.front();
+  libsgp4::DateTime start = pass.max_elevation_time;
+  libsgp4::TrajectoryGenerator track(observer_GPS, sgp4);
+  track.Prepare(start, start.AddSeconds(scan.Duration() + 1.0));
+  scan.Start(track, start, rate);
+
+  std::cout << "CRAFT: (" << tle.Name() << ") conical scan at " << start
+            << " for " << scan.Duration() << " s" << std::endl;
+
+  std::ofstream ofs("conical.csv");
+  libsgp4::PointingCommand block[kBlockSize];
+  size_t count;
+  while ((count = scan.Fill(block, kBlockSize)) > 0) {
+    for (size_t i = 0; i < count; ++i) {
+      ofs << block[i].ticks - libsgp4::UnixEpoch << ","
+          << libsgp4::Util::RadiansToDegrees(block[i].azimuth) << ","
+          << libsgp4::Util::RadiansToDegrees(block[i].elevation) << "\n";
+    }
+  }
+
+  return 0;
+}
@@ -1,4 +1,21 @@
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <BeamPeakEstimator.h>
+#include <DateTime.h>
+#include <PointingCommand.h>
+#include <PointingModel.h>
+#include <PointingModelSolver.h>
+#include <ScanPattern.h>
+#include <Util.h>
 
 // The idea is this:
 // 1) Move the positioner to the platonic look-angle at time=t0
@@ -28,3 +45,150 @@
 // to extrapolate the best elevation, the best azimuth.
 //
 //
+//
+// This tool runs the peak finding part of the procedure (steps 7-10) offline:
+// samples of (seconds, cross-elevation offset deg, elevation offset deg,
+// RSSI dB) are read from a CSV file, or synthesised for three diamond scans
+// around a known pointing error, and fed one at a time to the streaming beam
+// peak estimator. The final estimate becomes a CalPoint for the pointing
+// model solver.
+
+// synthetic beam: half power beam width, peak RSSI and noise, in deg / dB
+static const double kBeamWidth = 1.0;
+static const double kPeakRssi = -60.0;
+static const double kNoise = 0.3;
+// synthetic pointing error, deg
+static const double kTrueCrossElevation = 0.12;
+static const double kTrueElevation = -0.08;
+// diamond scans: radius deg, speed deg/s, sample rate Hz, count
+static const double kDiamondRadius = 0.3;
+static const double kDiamondSpeed = 0.2;
+static const double kSampleRate = 10.0;
+static const int kDiamonds = 3;
+
+static std::vector<libsgp4::BeamSample>
+read_samples(const std::string &filename) {
+  std::vector<libsgp4::BeamSample> samples;
+  std::ifstream infile(filename);
+  if (false == infile.is_open()) {
+    std::cout << "Failed to open RSSI file." << std::endl;
+    return samples;
+  }
+
+  std::string line;
+  while (std::getline(infile, line)) {
+    std::replace(line.begin(), line.end(), ',', ' ');
+    std::istringstream ss(line);
+    double seconds, cross_el, el, rssi;
+    if (!(ss >> seconds >> cross_el >> el >> rssi)) {
+      continue; // header or malformed line
+    }
+    samples.push_back(
+        {static_cast<int64_t>(seconds * 1e6),
+         libsgp4::Util::DegreesToRadians(cross_el),
+         libsgp4::Util::DegreesToRadians(el), rssi});
+  }
+  return samples;
+}
+
+static std::vector<libsgp4::BeamSample> synthesise_samples() {
+  std::vector<libsgp4::BeamSample> samples;
+  std::mt19937 generator(12345);
+  std::normal_distribution<double> noise(0.0, kNoise);
+
+  libsgp4::ScanParameters parameters;
+  parameters.type = libsgp4::ScanType::DIAMOND;
+  parameters.radius = libsgp4::Util::DegreesToRadians(kDiamondRadius);
+  parameters.speed = libsgp4::Util::DegreesToRadians(kDiamondSpeed);
+  libsgp4::ScanPattern scan(parameters);
+
+  int64_t ticks = 0;
+  for (int d = 0; d < kDiamonds; ++d) {
+    scan.Start(libsgp4::DateTime(ticks), kSampleRate);
+    libsgp4::PointingCommand command;
+    while (scan.Fill(&command, 1) == 1) {
+      // Gaussian beam: the loss in dB grows as 12 (offset / width)^2
+      double dx = libsgp4::Util::RadiansToDegrees(command.azimuth) -
+                  kTrueCrossElevation;
+      double dy = libsgp4::Util::RadiansToDegrees(command.elevation) -
+                  kTrueElevation;
+      double rssi = kPeakRssi -
+                    12.0 * (dx * dx + dy * dy) / (kBeamWidth * kBeamWidth) +
+                    noise(generator);
+      samples.push_back(
+          {command.ticks, command.azimuth, command.elevation, rssi});
+      ticks = command.ticks;
+    }
+    // 10 seconds between diamonds
+    ticks += 10000000;
+  }
+  return samples;
+}
+
+int main(int argc, char *argv[]) {
+  // usage: diamond_hands [rssi csv]
+  //        diamond_hands --synthetic [output csv]
+  std::vector<libsgp4::BeamSample> samples;
+  bool synthetic = argc < 2 || std::string(argv[1]) == "--synthetic";
+  if (synthetic) {
+    samples = synthesise_samples();
+    std::cout << "Synthetic pointing error: XEL(" << kTrueCrossElevation
+              << "), EL(" << kTrueElevation << ")" << std::endl;
+    if (argc > 2) {
+      std::ofstream ofs(argv[2]);
+      for (const auto &s : samples) {
+        ofs << s.ticks / 1e6 << ","
+            << libsgp4::Util::RadiansToDegrees(s.cross_elevation) << ","
+            << libsgp4::Util::RadiansToDegrees(s.elevation) << "," << s.rssi
+            << "\n";
+      }
+    }
+  } else {
+    samples = read_samples(argv[1]);
+  }
+
+  if (samples.empty()) {
+    std::cout << "No samples." << std::endl;
+    return -EXIT_FAILURE;
+  }
+
+  libsgp4::BeamPeakEstimator estimator;
+  libsgp4::BeamEstimate estimate;
+  for (size_t i = 0; i < samples.size(); ++i) {
+    estimate = estimator.Add(samples[i]);
+    if (estimate.valid && (i + 1) % 25 == 0) {
+      std::cout << "sample " << i + 1 << ": XEL("
+                << libsgp4::Util::RadiansToDegrees(estimate.cross_elevation)
+                << " +/- "
+                << libsgp4::Util::RadiansToDegrees(
+                       estimate.cross_elevation_sigma)
+                << "), EL("
+                << libsgp4::Util::RadiansToDegrees(estimate.elevation)
+                << " +/- "
+                << libsgp4::Util::RadiansToDegrees(estimate.elevation_sigma)
+                << ")" << std::endl;
+    }
+  }
+
+  if (!estimate.valid) {
+    std::cout << "The samples do not define a beam peak." << std::endl;
+    return -EXIT_FAILURE;
+  }
+  std::cout << "Peak RSSI " << estimate.peak_rssi << " dB, fit residual "
+            << estimate.rms_residual << " dB" << std::endl;
+
+  // the predicted look angle at the centre of the scans; here the first
+  // Inmarsat point of least_squares_fitting
+  libsgp4::CalPoint point;
+  estimator.GetCalPoint(libsgp4::Util::DegreesToRadians(235.15),
+                        libsgp4::Util::DegreesToRadians(42.12), point);
+  std::cout << "CalPoint: platonic AZ(" << point.platonic_az_deg << "), EL("
+            << point.platonic_el_deg << ") peak AZ(" << point.peak_az_deg
+            << "), EL(" << point.peak_el_deg << ")" << std::endl;
+
+  libsgp4::PointingModelSolver solver;
+  solver.Add(point);
+  std::cout << "Pointing model after " << solver.Count() << " point:\n"
+            << solver.Model();
+  return 0;
+}
@@ -1,6 +1,7 @@
 #include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 
 // Eigen is header-only – just drop Eigen into your include path
@@ -8,71 +9,15 @@
 #include <Eigen/Dense>
 #include <Eigen/QR>
 
-// ---------------------------------------------------------------------------
-// Simple structure to hold one calibration point (one GEO satellite)
-// ---------------------------------------------------------------------------
-struct CalPoint {
-  double platonic_az_deg; // theoretical azimuth  (degrees)
-  double platonic_el_deg; // theoretical elevation (degrees)
-  double peak_az_deg;     // encoder value at max SNR
-  double peak_el_deg;     // encoder value at max SNR
+#include <PointingModel.h>
+#include <PointingModelSolver.h>
+#include <Util.h>
 
-  // Residuals that the model will try to match
-  double dAz() const { return peak_az_deg - platonic_az_deg; }
-  double dEl() const { return peak_el_deg - platonic_el_deg; }
-};
-
-// ---------------------------------------------------------------------------
-// 7-parameter pointing correction model (more than enough for a 1 m dish)
-// ---------------------------------------------------------------------------
-// Corrected_Az = Az_cmd
-//                + AZ0   (azimuth zero offset)
-//                + AC    × cos(Az_cmd)          (E-W axis tilt)
-//                + AN    × sin(Az_cmd)          (N-S axis tilt)
-//                + COLL  × tan(El_cmd)          (collimation /
-//                non-orthogonality)
-//
-// Corrected_El = El_cmd
-//                + EL0   (elevation zero offset)
-//                + GRAV  × cos(El_cmd)          (gravity sag – small on small
-//                dishes)
-//                + EL_LIN × sin(El_cmd)         (optional linear term)
-// ---------------------------------------------------------------------------
-struct PointingModel {
-  double AZ0 = 0.0;    // Azimuth zero offset        (deg)
-  double AN = 0.0;     // N-S axis tilt              (deg)
-  double AC = 0.0;     // E-W axis tilt              (deg)
-  double COLL = 0.0;   // Collimation error          (deg)
-  double EL0 = 0.0;    // Elevation zero offset      (deg)
-  double GRAV = 0.0;   // Gravity term (cos El)      (deg)
-  double EL_LIN = 0.0; // Optional elevation linearity (deg)
-
-  // Apply the correction to a raw command
-  void applyCorrection(double az_cmd_deg, double el_cmd_deg,
-                       double &az_corrected, double &el_corrected) const {
-    double az_rad = az_cmd_deg * M_PI / 180.0;
-    double el_rad = el_cmd_deg * M_PI / 180.0;
-
-    az_corrected = az_cmd_deg + AZ0 + AN * std::sin(az_rad) +
-                   AC * std::cos(az_rad) + COLL * std::tan(el_rad);
-
-    el_corrected =
-        el_cmd_deg + EL0 + GRAV * std::cos(el_rad) + EL_LIN * std::sin(el_rad);
-  }
-
-  void print() const {
-    std::cout << std::fixed << std::setprecision(5);
-    std::cout << "AZ0    (az offset)    = " << AZ0 << " °\n";
-    std::cout << "AN     (N-S tilt)     = " << AN << " °\n";
-        std::cout << "AC     (E-W tilt
-
-)     = " << AC    << " °\n";
-        std::cout << "COLL   (collimation)  = " << COLL  << " °\n";
-        std::cout << "EL0    (el offset)    = " << EL0 << " °\n";
-        std::cout << "GRAV   (gravity)      = " << GRAV << " °\n";
-        std::cout << "EL_LIN (linearity)    = " << EL_LIN << " °\n";
-  }
-};
+// The calibration point and the 7-parameter pointing correction model
+// (AZ0, AN, AC, COLL, EL0, GRAV, EL_LIN) live in libsgp4, so the fitted model
+// can be saved and applied directly in Observer::GetLookAngles.
+using libsgp4::CalPoint;
+using libsgp4::PointingModel;
 
 // ---------------------------------------------------------------------------
 // Least-squares solver – works with 2 or more points
@@ -82,11 +27,12 @@ PointingModel solvePointingModel(const std::vector<CalPoint> &points) {
     throw std::runtime_error("Need at least 2 calibration points");
   }
 
-  Eigen::MatrixXd A(points.size() * 2, 7); // 2 equations per point
-  Eigen::VectorXd b(points.size() * 2);
+  const Eigen::Index rows = static_cast<Eigen::Index>(points.size() * 2);
+  Eigen::MatrixXd A(rows, 7); // 2 equations per point
+  Eigen::VectorXd b(rows);
 
-  for (size_t i = 0; i < points.size(); ++i) {
-    const auto &p = points[i];
+  for (Eigen::Index i = 0; i < rows / 2; ++i) {
+    const auto &p = points[static_cast<size_t>(i)];
     double az_rad = p.platonic_az_deg * M_PI / 180.0;
     double el_rad = p.platonic_el_deg * M_PI / 180.0;
 
@@ -111,13 +57,13 @@ PointingModel solvePointingModel(const std::vector<CalPoint> &points) {
   Eigen::VectorXd x = A.householderQr().solve(b);
 
   PointingModel model;
-  model.AZ0 = x(0);
-  model.AN = x(1);
-  model.AC = x(2);
-  model.COLL = x(3);
-  model.EL0 = x(4);
-  model.GRAV = x(5);
-  model.EL_LIN = x(6);
+  model.az0 = x(0);
+  model.an = x(1);
+  model.ac = x(2);
+  model.coll = x(3);
+  model.el0 = x(4);
+  model.grav = x(5);
+  model.el_lin = x(6);
 
   // Optional: print RMS residual
   double rms = std::sqrt((b - A * x).squaredNorm() / b.size());
@@ -134,25 +80,42 @@ int main() {
   std::vector<CalPoint> cal;
 
   // Example data – replace with your real peaked values!
-  cal.push_back({.platonic_az_deg = 235.15,
-                 .platonic_el_deg = 42.12,
-                 .peak_az_deg = 236.78,
-                 .peak_el_deg = 41.69});
-
-  cal.push_back({.platonic_az_deg = 197.31,
-                 .platonic_el_deg = 38.41,
-                 .peak_az_deg = 198.51,
-                 .peak_el_deg = 38.93});
+  // Each point is platonic az, platonic el, peak az, peak el (degrees).
+  cal.push_back({235.15, 42.12, 236.78, 41.69});
+  cal.push_back({197.31, 38.41, 198.51, 38.93});
 
   // Add more if you peak a third or fourth GEO...
+  // (the batch fit needs at least four points to determine all 7 terms)
+  cal.push_back({160.42, 55.87, 161.18, 56.21});
+  cal.push_back({121.06, 30.55, 121.44, 30.92});
+  cal.push_back({262.73, 21.36, 264.65, 20.88});
 
   PointingModel model = solvePointingModel(cal);
-  model.print();
+  std::cout << model;
+
+  // The incremental solver takes the points one at a time, as they are
+  // peaked, and ends up with the same model as the batch fit.
+  libsgp4::PointingModelSolver solver;
+  for (const auto &p : cal) {
+    solver.Add(p);
+    std::cout << "After " << solver.Count() << " points: RMS residual "
+              << solver.RmsResidual() << " °\n";
+  }
+  PointingModel incremental = solver.Model();
+  std::cout << "\nIncremental model:\n" << incremental;
+
+  libsgp4::PointingModelSolver::Covariance covariance;
+  if (solver.GetCovariance(covariance)) {
+    std::cout << "1-sigma AZ0 " << std::sqrt(covariance[0][0]) << " °, EL0 "
+              << std::sqrt(covariance[4][4]) << " °\n";
+  }
 
   // Test the correction on one of the points
-  double az_corr, el_corr;
-  model.applyCorrection(cal[0].platonic_az_deg, cal[0].platonic_el_deg, az_corr,
-                        el_corr);
+  double az_corr = libsgp4::Util::DegreesToRadians(cal[0].platonic_az_deg);
+  double el_corr = libsgp4::Util::DegreesToRadians(cal[0].platonic_el_deg);
+  model.Apply(az_corr, el_corr);
+  az_corr = libsgp4::Util::RadiansToDegrees(az_corr);
+  el_corr = libsgp4::Util::RadiansToDegrees(el_corr);
   std::cout << "\nTest on first GEO (should match peak values):\n";
   std::cout << "Corrected Az = " << az_corr << " °   (peak was "
             << cal[0].peak_az_deg << " °)\n";
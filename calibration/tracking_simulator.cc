@@ -0,0 +1,339 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <BeamPeakEstimator.h>
+#include <CoordGeodetic.h>
+#include <DateTime.h>
+#include <PointingCommand.h>
+#include <PointingModel.h>
+#include <PointingModelSolver.h>
+#include <SGP4.h>
+#include <ScanPattern.h>
+#include <TrajectoryGenerator.h>
+#include <Util.h>
+
+// Closed-loop simulation of the calibration stack, without hardware. A mount
+// with a known pointing error (the PointingModel terms) tracks the craft of
+// a TLE file through the current estimate of that error. Every scan interval
+// it runs a diamond scan around one visible craft, the RSSI of each sample
+// coming from a Gaussian beam about the true pointing plus noise. The beam
+// peak estimator turns each scan into a CalPoint, and the pointing model
+// solver refits the model the tracking uses.
+//
+// Time is simulated, from the epoch of the first craft, and the noise is
+// seeded, so a run is reproducible. It reports when the tracking error
+// converged, the pointing accuracy reached and the CPU time per simulated
+// second, and exits non-zero if the error never converged. The accuracy is
+// judged where the craft were scanned: the individual terms are only as
+// observable as the sky the craft cover, which for an equatorial
+// constellation is a band in the south.
+
+// beam: half power beam width, peak RSSI and noise, in deg / dB
+static const double kBeamWidth = 1.0;
+static const double kPeakRssi = -60.0;
+static const double kNoise = 0.3;
+// diamond scans: radius deg, speed deg/s, sample rate Hz
+static const double kDiamondRadius = 0.3;
+static const double kDiamondSpeed = 0.5;
+static const double kSampleRate = 10.0;
+// seconds from the start of one scan to the next
+static const int kScanInterval = 60;
+// elevations scanned at, deg; COLL grows as tan(el) towards the zenith
+static const double kMinElevation = 15.0;
+static const double kMaxElevation = 80.0;
+// a scan is used when the peak is known to better than this, deg
+static const double kMaxSigma = 0.05;
+// tracking error counted as converged, deg
+static const double kConverged = 0.05;
+// the latest fit is tracked with where its predicted uncertainty is below
+// this, deg
+static const double kMaxModelSigma = 0.03;
+
+// the mount error when no model file is given, deg
+static libsgp4::PointingModel default_truth() {
+  libsgp4::PointingModel truth;
+  truth.az0 = 0.30;
+  truth.an = 0.05;
+  truth.ac = -0.04;
+  truth.coll = 0.03;
+  truth.el0 = -0.20;
+  truth.grav = 0.10;
+  truth.el_lin = 0.02;
+  return truth;
+}
+
+static std::vector<libsgp4::Tle> fetch_tles(const std::string &tle_filename) {
+  std::vector<libsgp4::Tle> tles;
+  std::ifstream infile(tle_filename);
+  if (false == infile.is_open()) {
+    std::cout << "Failed to open TLE File." << std::endl;
+    return tles;
+  }
+
+  std::string name, line1, line2;
+  while (std::getline(infile, name) && std::getline(infile, line1) &&
+         std::getline(infile, line2)) {
+    tles.emplace_back(name, line1, line2);
+  }
+  return tles;
+}
+
+// angle on the sky between where a model and the truth point the mount for
+// a look angle (radians), in degrees
+static double pointing_error(const libsgp4::PointingModel &model,
+                             const libsgp4::PointingModel &truth, double az,
+                             double el) {
+  double model_az = az, model_el = el;
+  double true_az = az, true_el = el;
+  model.Apply(model_az, model_el);
+  truth.Apply(true_az, true_el);
+  double dx = libsgp4::Util::WrapNegPosPI(model_az - true_az) * std::cos(el);
+  double dy = model_el - true_el;
+  return libsgp4::Util::RadiansToDegrees(std::hypot(dx, dy));
+}
+
+// a look angle in radians
+struct Direction {
+  double azimuth;
+  double elevation;
+};
+
+// RMS pointing error over a set of directions, in degrees
+static double rms_error(const libsgp4::PointingModel &model,
+                        const libsgp4::PointingModel &truth,
+                        const std::vector<Direction> &directions) {
+  double sum = 0.0;
+  for (const auto &d : directions) {
+    double e = pointing_error(model, truth, d.azimuth, d.elevation);
+    sum += e * e;
+  }
+  return directions.empty() ? 0.0 : std::sqrt(sum / directions.size());
+}
+
+// predicted 1-sigma uncertainty of the fitted model's pointing for a look
+// angle (radians), in degrees, from the covariance of its terms
+static double pointing_sigma(const libsgp4::PointingModelSolver &solver,
+                             double az, double el) {
+  libsgp4::PointingModelSolver::Covariance covariance;
+  if (!solver.GetCovariance(covariance)) {
+    return HUGE_VAL;
+  }
+
+  // the terms each offset moves with, as in the solver, with the azimuth
+  // scaled onto the sky
+  const size_t n = libsgp4::PointingModelSolver::kParameters;
+  double cos_el = std::cos(el);
+  double rows[2][n] = {{cos_el, std::sin(az) * cos_el, std::cos(az) * cos_el,
+                        std::sin(el), 0.0, 0.0, 0.0},
+                       {0.0, 0.0, 0.0, 0.0, 1.0, cos_el, std::sin(el)}};
+  double variance = 0.0;
+  for (const auto &row : rows) {
+    for (size_t i = 0; i < n; ++i) {
+      for (size_t j = 0; j < n; ++j) {
+        variance += row[i] * covariance[i][j] * row[j];
+      }
+    }
+  }
+  return std::sqrt(variance);
+}
+
+int main(int argc, char *argv[]) {
+  // usage: tracking_simulator [tle file] [hours] [seed] [truth model file]
+  std::string tle_filename = argc > 1 ? argv[1] : "../visible_craft/mPOWER.tle";
+  double hours = argc > 2 ? std::atof(argv[2]) : 6.0;
+  unsigned int seed =
+      argc > 3 ? static_cast<unsigned int>(std::strtoul(argv[3], nullptr, 10))
+               : 12345;
+
+  libsgp4::PointingModel truth = default_truth();
+  if (argc > 4) {
+    try {
+      truth = libsgp4::PointingModel::FromFile(argv[4]);
+    } catch (const std::exception &e) {
+      std::cout << e.what() << std::endl;
+      return -EXIT_FAILURE;
+    }
+  }
+
+  std::vector<libsgp4::Tle> tles = fetch_tles(tle_filename);
+  if (tles.empty()) {
+    std::cout << "No craft in the TLE file." << std::endl;
+    return -EXIT_FAILURE;
+  }
+  std::vector<libsgp4::SGP4> craft;
+  for (const auto &tle : tles) {
+    craft.emplace_back(tle);
+  }
+
+  // lat/lon/altitude of PIE airport.
+  libsgp4::CoordGeodetic observer_GPS(27.9086, -82.6865, 3.0);
+
+  std::vector<libsgp4::TrajectoryGenerator> tracks;
+  for (const auto &sgp4 : craft) {
+    tracks.emplace_back(observer_GPS, sgp4);
+  }
+
+  std::mt19937 generator(seed);
+  std::normal_distribution<double> noise(0.0, kNoise);
+
+  libsgp4::ScanParameters parameters;
+  parameters.type = libsgp4::ScanType::DIAMOND;
+  parameters.radius = libsgp4::Util::DegreesToRadians(kDiamondRadius);
+  parameters.speed = libsgp4::Util::DegreesToRadians(kDiamondSpeed);
+  libsgp4::ScanPattern scan(parameters);
+
+  libsgp4::PointingModelSolver solver;
+  libsgp4::PointingModel model;
+
+  const libsgp4::DateTime start = tles.front().Epoch();
+  const int scans = static_cast<int>(hours * 3600.0 / kScanInterval);
+  const double min_el = libsgp4::Util::DegreesToRadians(kMinElevation);
+  const double max_el = libsgp4::Util::DegreesToRadians(kMaxElevation);
+
+  std::cout << "Truth:\n" << truth;
+  size_t samples = 0;
+  int scanned = 0;
+  int rejected = 0;
+  double converged_at = -1.0;
+  double tracking_sum = 0.0;
+  int tracking_count = 0;
+  size_t next_craft = 0;
+  double updated_at = -1.0;
+  std::vector<Direction> directions;
+
+  std::clock_t cpu_start = std::clock();
+  for (int k = 0; k < scans; ++k) {
+    const libsgp4::DateTime scan_start = start.AddSeconds(k * kScanInterval);
+
+    // the next visible craft, round robin
+    libsgp4::TrajectoryGenerator *track = nullptr;
+    for (size_t n = 0; n < tracks.size() && track == nullptr; ++n) {
+      size_t c = (next_craft + n) % tracks.size();
+      tracks[c].Prepare(scan_start, scan_start.AddSeconds(scan.Duration()));
+      libsgp4::PointingCommand mid = tracks[c].Interpolate(
+          scan_start.AddSeconds(scan.Duration() / 2.0).Ticks());
+      if (mid.elevation >= min_el && mid.elevation <= max_el) {
+        track = &tracks[c];
+        next_craft = c + 1;
+      }
+    }
+    if (track == nullptr) {
+      continue;
+    }
+
+    libsgp4::PointingCommand mid = track->Interpolate(
+        scan_start.AddSeconds(scan.Duration() / 2.0).Ticks());
+
+    directions.push_back({mid.azimuth, mid.elevation});
+
+    // a few points leave some terms barely determined, and a fit can be
+    // wild away from its points, so the tracking only uses it where it is
+    // known to point well and otherwise trusts the mount as built
+    if (pointing_sigma(solver, mid.azimuth, mid.elevation) < kMaxModelSigma) {
+      model = solver.Model();
+      if (updated_at < 0.0) {
+        updated_at = k * kScanInterval;
+      }
+    } else {
+      model = libsgp4::PointingModel();
+    }
+
+    // the error the tracking had going into the scan
+    double tracking = pointing_error(model, truth, mid.azimuth, mid.elevation);
+    tracking_sum += tracking * tracking;
+    tracking_count++;
+    if (tracking >= kConverged) {
+      converged_at = -1.0;
+    } else if (converged_at < 0.0) {
+      converged_at = k * kScanInterval;
+    }
+
+    // offsets only; the track is followed through the model below
+    libsgp4::BeamPeakEstimator estimator;
+    libsgp4::PointingCommand offset;
+    scan.Start(scan_start, kSampleRate);
+    while (scan.Fill(&offset, 1) == 1) {
+      libsgp4::PointingCommand sat = track->Interpolate(offset.ticks);
+      double centre_az = sat.azimuth, centre_el = sat.elevation;
+      double peak_az = sat.azimuth, peak_el = sat.elevation;
+      model.Apply(centre_az, centre_el);
+      truth.Apply(peak_az, peak_el);
+
+      // Gaussian beam: the loss in dB grows as 12 (offset / width)^2
+      double cos_el = std::cos(centre_el);
+      double dx = libsgp4::Util::RadiansToDegrees(
+          libsgp4::Util::WrapNegPosPI(centre_az - peak_az) * cos_el +
+          offset.azimuth);
+      double dy = libsgp4::Util::RadiansToDegrees(centre_el - peak_el +
+                                                  offset.elevation);
+      double rssi = kPeakRssi -
+                    12.0 * (dx * dx + dy * dy) / (kBeamWidth * kBeamWidth) +
+                    noise(generator);
+      estimator.Add({offset.ticks, offset.azimuth, offset.elevation, rssi});
+      samples++;
+    }
+    scanned++;
+
+    libsgp4::BeamEstimate estimate = estimator.Estimate();
+    double centre_az = mid.azimuth, centre_el = mid.elevation;
+    model.Apply(centre_az, centre_el);
+    libsgp4::CalPoint point;
+    if (!estimate.valid ||
+        libsgp4::Util::RadiansToDegrees(std::max(
+            estimate.cross_elevation_sigma, estimate.elevation_sigma)) >
+            kMaxSigma ||
+        !estimator.GetCalPoint(centre_az, centre_el, point)) {
+      rejected++;
+      continue;
+    }
+    // the peak was found about the model's pointing, but the model fits
+    // the error from the predicted look angle
+    double peak_offset = libsgp4::Util::WrapNegPosPI(
+        libsgp4::Util::DegreesToRadians(point.peak_az_deg) - mid.azimuth);
+    point.platonic_az_deg = libsgp4::Util::RadiansToDegrees(mid.azimuth);
+    point.platonic_el_deg = libsgp4::Util::RadiansToDegrees(mid.elevation);
+    point.peak_az_deg = libsgp4::Util::RadiansToDegrees(mid.azimuth + peak_offset);
+    solver.Add(point);
+
+  }
+  double cpu = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+  double simulated = hours * 3600.0;
+
+  std::cout << "Scans " << scanned << " (" << rejected << " rejected), "
+            << samples << " samples, " << solver.Count() << " cal points"
+            << std::endl;
+  std::cout << "Fitted:\n" << solver.Model();
+  std::cout << "Fit RMS residual " << solver.RmsResidual() << " deg"
+            << std::endl;
+  std::cout << "Tracking RMS error "
+            << (tracking_count > 0 ? std::sqrt(tracking_sum / tracking_count)
+                                   : 0.0)
+            << " deg" << std::endl;
+  std::cout << "RMS error over the scanned directions: uncorrected "
+            << rms_error(libsgp4::PointingModel(), truth, directions)
+            << " deg, fitted " << rms_error(solver.Model(), truth, directions)
+            << " deg" << std::endl;
+  if (updated_at >= 0.0) {
+    std::cout << "First model used after " << updated_at << " s"
+              << std::endl;
+  }
+  if (converged_at >= 0.0) {
+    std::cout << "Converged below " << kConverged << " deg after "
+              << converged_at << " s" << std::endl;
+  } else {
+    std::cout << "Did not converge below " << kConverged << " deg"
+              << std::endl;
+  }
+  std::cout << "CPU " << cpu * 1e6 / simulated << " us per simulated second"
+            << std::endl;
+
+  return converged_at >= 0.0 ? 0 : -EXIT_FAILURE;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "BeamPeakEstimator.h"
+
+#include "Util.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace libsgp4
+{
+
+BeamEstimate BeamPeakEstimator::Add( const BeamSample& sample )
+{
+   const double x = Util::RadiansToDegrees( sample.cross_elevation );
+   const double y = Util::RadiansToDegrees( sample.elevation );
+
+   m_solver.Forget();
+   m_solver.Add( { 1.0, x, y, x * x, y * y }, sample.rssi );
+
+   return Estimate();
+}
+
+BeamEstimate BeamPeakEstimator::Estimate() const
+{
+   BeamEstimate estimate;
+
+   IncrementalLeastSquares<5>::Matrix covariance;
+   if ( !m_solver.Covariance( covariance ) )
+   {
+      return estimate;
+   }
+
+   const IncrementalLeastSquares<5>::Row c = m_solver.Solve();
+
+   /*
+    * a peak needs the parabola to open downwards on both axes
+    */
+   if ( c[3] >= 0.0 || c[4] >= 0.0 )
+   {
+      return estimate;
+   }
+
+   const double x = -c[1] / ( 2.0 * c[3] );
+   const double y = -c[2] / ( 2.0 * c[4] );
+
+   /*
+    * first order propagation of the covariance through the peak position;
+    * x depends on c1 and c3 only, y on c2 and c4 only
+    */
+   const double dx_dc1 = -1.0 / ( 2.0 * c[3] );
+   const double dx_dc3 = c[1] / ( 2.0 * c[3] * c[3] );
+   const double dy_dc2 = -1.0 / ( 2.0 * c[4] );
+   const double dy_dc4 = c[2] / ( 2.0 * c[4] * c[4] );
+   const double var_x = dx_dc1 * dx_dc1 * covariance[1][1]
+                        + 2.0 * dx_dc1 * dx_dc3 * covariance[1][3]
+                        + dx_dc3 * dx_dc3 * covariance[3][3];
+   const double var_y = dy_dc2 * dy_dc2 * covariance[2][2]
+                        + 2.0 * dy_dc2 * dy_dc4 * covariance[2][4]
+                        + dy_dc4 * dy_dc4 * covariance[4][4];
+
+   estimate.valid = true;
+   estimate.cross_elevation = Util::DegreesToRadians( x );
+   estimate.elevation = Util::DegreesToRadians( y );
+   estimate.cross_elevation_sigma = Util::DegreesToRadians( std::sqrt( std::max( var_x, 0.0 ) ) );
+   estimate.elevation_sigma = Util::DegreesToRadians( std::sqrt( std::max( var_y, 0.0 ) ) );
+   estimate.peak_rssi = c[0] + c[1] * x + c[2] * y + c[3] * x * x + c[4] * y * y;
+   estimate.rms_residual = m_solver.RmsResidual();
+   return estimate;
+}
+
+bool BeamPeakEstimator::GetCalPoint( const double azimuth,
+                                     const double elevation,
+                                     CalPoint& point ) const
+{
+   const BeamEstimate estimate = Estimate();
+   if ( !estimate.valid )
+   {
+      return false;
+   }
+
+   const double cos_el = std::cos( elevation );
+   if ( cos_el <= 0.0 )
+   {
+      return false;
+   }
+
+   point.platonic_az_deg = Util::RadiansToDegrees( azimuth );
+   point.platonic_el_deg = Util::RadiansToDegrees( elevation );
+   point.peak_az_deg = Util::RadiansToDegrees( azimuth
+                       + estimate.cross_elevation / cos_el );
+   point.peak_el_deg = Util::RadiansToDegrees( elevation + estimate.elevation );
+   return true;
+}
+
+} // namespace libsgp4
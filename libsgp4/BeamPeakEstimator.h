@@ -0,0 +1,139 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "IncrementalLeastSquares.h"
+#include "PointingModel.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libsgp4
+{
+
+/**
+ * @brief One signal strength sample taken during a scan.
+ */
+struct BeamSample
+{
+   /** time of the sample in DateTime ticks */
+   int64_t ticks;
+   /** commanded cross-elevation offset from the track in radians */
+   double cross_elevation;
+   /** commanded elevation offset from the track in radians */
+   double elevation;
+   /** received signal strength in dB */
+   double rssi;
+};
+
+/**
+ * @brief The estimated beam peak after a sample.
+ */
+struct BeamEstimate
+{
+   /** the samples so far define a peak */
+   bool valid{};
+   /** cross-elevation offset of the peak from the track in radians */
+   double cross_elevation{};
+   /** elevation offset of the peak from the track in radians */
+   double elevation{};
+   /** 1-sigma uncertainty of the cross-elevation offset in radians */
+   double cross_elevation_sigma{};
+   /** 1-sigma uncertainty of the elevation offset in radians */
+   double elevation_sigma{};
+   /** signal strength at the peak in dB */
+   double peak_rssi{};
+   /** RMS residual of the beam fit in dB */
+   double rms_residual{};
+};
+
+/**
+ * @brief Estimates the pointing error from signal strength samples as they
+ * arrive.
+ *
+ * Near its peak a Gaussian beam is a parabola in dB, so each sample adds
+ * one observation of
+ *
+ * rssi = c0 + c1 x + c2 y + c3 x^2 + c4 y^2
+ *
+ * to an incremental least squares fit, with x the cross-elevation and y the
+ * elevation offset. The peak is at (-c1 / 2 c3, -c2 / 2 c4) and its
+ * uncertainty follows from the covariance of the fit. Memory is fixed and
+ * the cost per sample bounded; a forgetting factor lets the estimate follow
+ * a drifting peak.
+ */
+class BeamPeakEstimator
+{
+public:
+   /**
+    * Constructor
+    * @param[in] forgetting_factor weight kept by earlier samples each time
+    * one is added, in (0, 1]
+    */
+   explicit BeamPeakEstimator( const double forgetting_factor = 1.0 )
+      : m_solver( forgetting_factor )
+   {
+   }
+
+   /**
+    * Add a sample
+    * @param[in] sample the sample
+    * @returns the estimate including the sample
+    */
+   BeamEstimate Add( const BeamSample& sample );
+
+   /**
+    * @returns the estimate from the samples so far
+    */
+   BeamEstimate Estimate() const;
+
+   /**
+    * Build a calibration point from the current estimate
+    * @param[in] azimuth predicted azimuth of the satellite at the centre of
+    * the scan in radians
+    * @param[in] elevation predicted elevation of the satellite at the
+    * centre of the scan in radians
+    * @param[out] point the calibration point
+    * @returns false while the estimate is not valid
+    */
+   bool GetCalPoint( const double azimuth,
+                     const double elevation,
+                     CalPoint& point ) const;
+
+   /**
+    * @returns the number of samples added
+    */
+   size_t Count() const
+   {
+      return m_solver.Count();
+   }
+
+   /**
+    * Discard all samples
+    */
+   void Reset()
+   {
+      m_solver.Reset();
+   }
+
+private:
+   /** fit of the beam, with the offsets in degrees for conditioning */
+   IncrementalLeastSquares<5> m_solver;
+};
+
+} // namespace libsgp4
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "DopplerTable.h"
+
+#include "CoordTopocentric.h"
+#include "Eci.h"
+#include "Tracing.h"
+#include "Globals.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iomanip>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * half width in seconds of the central difference used for the node range
+ * acceleration
+ */
+const double kAccelerationStepSeconds = 0.5;
+
+/*
+ * append an unsigned value to a buffer, least significant byte first
+ */
+template <typename T>
+char* PutLittleEndian( char* p, const T value, const size_t size )
+{
+   for ( size_t i = 0; i < size; i++ )
+   {
+      *p++ = static_cast<char>( ( value >> ( 8 * i ) ) & 0xff );
+   }
+   return p;
+}
+
+char* PutFloat( char* p, const float value )
+{
+   uint32_t bits;
+   std::memcpy( &bits, &value, sizeof( bits ) );
+   return PutLittleEndian( p, bits, sizeof( bits ) );
+}
+
+char* PutDouble( char* p, const double value )
+{
+   uint64_t bits;
+   std::memcpy( &bits, &value, sizeof( bits ) );
+   return PutLittleEndian( p, bits, sizeof( bits ) );
+}
+}
+
+PropagationStatus DopplerTable::Prepare( const DateTime& start,
+      const DateTime& end,
+      const int coarse_step )
+{
+   SGP4_TRACE_SCOPE( "DopplerTable::Prepare" );
+
+   m_start = start.Ticks();
+   m_end = std::max( end.Ticks(), m_start );
+   m_step = std::max<int64_t>( coarse_step, 1 ) * TicksPerSecond;
+
+   const int64_t intervals = ( m_end - m_start + m_step - 1 ) / m_step;
+   m_nodes.clear();
+   m_nodes.reserve( static_cast<size_t>( intervals ) + 1 );
+
+   for ( int64_t i = 0; i <= intervals; i++ )
+   {
+      Node node;
+      const PropagationStatus status = Evaluate( DateTime( m_start + i * m_step ), node );
+      if ( status != PropagationStatus::OK )
+      {
+         m_nodes.clear();
+         return status;
+      }
+      m_nodes.push_back( node );
+   }
+   return PropagationStatus::OK;
+}
+
+PropagationStatus DopplerTable::Evaluate( const DateTime& dt, Node& node )
+{
+   /*
+    * the range acceleration is dominated by the satellite's own
+    * acceleration near closest approach, so the neighbours are propagated
+    * rather than extrapolated along the velocity
+    */
+   Eci eci( dt, Vector() );
+   Eci eci_before( dt, Vector() );
+   Eci eci_after( dt, Vector() );
+   PropagationStatus status = m_sgp4.Propagate( dt, eci );
+   if ( status == PropagationStatus::OK )
+   {
+      status = m_sgp4.Propagate( dt.AddSeconds( -kAccelerationStepSeconds ), eci_before );
+   }
+   if ( status == PropagationStatus::OK )
+   {
+      status = m_sgp4.Propagate( dt.AddSeconds( kAccelerationStepSeconds ), eci_after );
+   }
+   if ( status != PropagationStatus::OK )
+   {
+      return status;
+   }
+
+   const CoordTopocentric topo = m_observer.GetLookAngle( eci );
+   const CoordTopocentric topo_before = m_observer.GetLookAngle( eci_before );
+   const CoordTopocentric topo_after = m_observer.GetLookAngle( eci_after );
+
+   node.range = topo.m_range;
+   node.range_rate = topo.m_range_rate;
+   node.range_acceleration = ( topo_after.m_range_rate - topo_before.m_range_rate )
+                             / ( 2.0 * kAccelerationStepSeconds );
+   return PropagationStatus::OK;
+}
+
+DopplerSample DopplerTable::Interpolate( const int64_t ticks ) const
+{
+   DopplerSample sample{};
+   sample.ticks = ticks;
+
+   if ( m_nodes.empty() )
+   {
+      return sample;
+   }
+
+   if ( m_nodes.size() == 1 )
+   {
+      sample.range = m_nodes.front().range;
+      sample.range_rate = m_nodes.front().range_rate;
+   }
+   else
+   {
+      const int64_t offset = std::min( std::max( ticks, m_start ), m_end ) - m_start;
+      const size_t i = std::min( static_cast<size_t>( offset / m_step ),
+                                 m_nodes.size() - 2 );
+
+      /*
+       * cubic Hermite basis over the segment, with s in [0, 1]
+       */
+      const double h = static_cast<double>( m_step ) / TicksPerSecond;
+      const double s = static_cast<double>( offset - static_cast<int64_t>( i ) * m_step )
+                       / static_cast<double>( m_step );
+      const double s2 = s * s;
+      const double s3 = s2 * s;
+      const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+      const double h10 = s3 - 2.0 * s2 + s;
+      const double h01 = -2.0 * s3 + 3.0 * s2;
+      const double h11 = s3 - s2;
+
+      const Node& n0 = m_nodes[i];
+      const Node& n1 = m_nodes[i + 1];
+
+      sample.range = h00 * n0.range
+                     + h10 * h * n0.range_rate
+                     + h01 * n1.range
+                     + h11 * h * n1.range_rate;
+      sample.range_rate = h00 * n0.range_rate
+                          + h10 * h * n0.range_acceleration
+                          + h01 * n1.range_rate
+                          + h11 * h * n1.range_acceleration;
+   }
+
+   /*
+    * the received downlink is shifted by -f v / c; the uplink is sent at
+    * f c / (c - v) so that it arrives at f
+    */
+   sample.light_time = sample.range / kC;
+   sample.downlink_offset = -m_downlink_frequency * sample.range_rate / kC;
+   sample.uplink_offset = m_uplink_frequency * sample.range_rate
+                          / ( kC - sample.range_rate );
+   return sample;
+}
+
+size_t DopplerTable::SampleCount( const double rate ) const
+{
+   if ( m_nodes.empty() || rate <= 0.0 )
+   {
+      return 0;
+   }
+
+   const double interval = TicksPerSecond / rate;
+   return static_cast<size_t>( static_cast<double>( m_end - m_start ) / interval ) + 1;
+}
+
+DopplerSample DopplerTable::Sample( const size_t i, const double rate ) const
+{
+   const double interval = TicksPerSecond / rate;
+   return Interpolate( m_start + static_cast<int64_t>(
+                          std::llround( static_cast<double>( i ) * interval ) ) );
+}
+
+void DopplerTable::Generate( const double rate,
+                             std::vector<DopplerSample>& samples ) const
+{
+   const size_t count = SampleCount( rate );
+   samples.clear();
+   samples.reserve( count );
+   for ( size_t i = 0; i < count; i++ )
+   {
+      samples.push_back( Sample( i, rate ) );
+   }
+}
+
+size_t DopplerTable::WriteCsv( std::ostream& os, const double rate ) const
+{
+   const size_t count = SampleCount( rate );
+   const std::ios::fmtflags flags = os.flags();
+   const std::streamsize precision = os.precision();
+
+   os << std::fixed;
+   for ( size_t i = 0; i < count; i++ )
+   {
+      const DopplerSample sample = Sample( i, rate );
+      const int64_t unix_ticks = sample.ticks - UnixEpoch;
+      os << std::setprecision( 6 )
+         << static_cast<double>( unix_ticks ) / TicksPerSecond << ","
+         << sample.range << ","
+         << sample.range_rate << ","
+         << std::setprecision( 9 ) << sample.light_time << ","
+         << std::setprecision( 3 ) << sample.downlink_offset << ","
+         << sample.uplink_offset << "\n";
+   }
+
+   os.flags( flags );
+   os.precision( precision );
+   return count;
+}
+
+size_t DopplerTable::WriteBinary( std::ostream& os, const double rate ) const
+{
+   const size_t count = SampleCount( rate );
+
+   char header[24];
+   char* p = header;
+   std::memcpy( p, "DOPP", 4 );
+   p += 4;
+   p = PutLittleEndian( p, static_cast<uint32_t>( count ), 4 );
+   p = PutDouble( p, m_downlink_frequency );
+   PutDouble( p, m_uplink_frequency );
+   os.write( header, sizeof( header ) );
+
+   char record[24];
+   for ( size_t i = 0; i < count; i++ )
+   {
+      const DopplerSample sample = Sample( i, rate );
+      p = PutLittleEndian( record, static_cast<uint64_t>( sample.ticks ), 8 );
+      p = PutFloat( p, static_cast<float>( sample.downlink_offset ) );
+      p = PutFloat( p, static_cast<float>( sample.uplink_offset ) );
+      p = PutFloat( p, static_cast<float>( sample.light_time ) );
+      PutFloat( p, static_cast<float>( sample.range_rate ) );
+      os.write( record, sizeof( record ) );
+   }
+
+   return count;
+}
+
+} // namespace libsgp4
@@ -0,0 +1,192 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "CoordGeodetic.h"
+#include "DateTime.h"
+#include "Observer.h"
+#include "PropagationStatus.h"
+#include "SGP4.h"
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Frequency and delay corrections for one instant of a pass.
+ */
+struct DopplerSample
+{
+   /** time of the sample in DateTime ticks */
+   int64_t ticks;
+   /** range to the satellite in km */
+   double range;
+   /** range rate in km/s, positive when receding */
+   double range_rate;
+   /** one-way light time in seconds */
+   double light_time;
+   /** offset of the received downlink from its nominal frequency in Hz */
+   double downlink_offset;
+   /** offset to transmit the uplink at so it arrives on its nominal
+    * frequency, in Hz */
+   double uplink_offset;
+};
+
+/**
+ * @brief Generates Doppler and delay tables for a span of time, usually a
+ * pass.
+ *
+ * The satellite is propagated once per coarse step when the span is
+ * prepared, recording the range, range rate and range acceleration at each
+ * node. Samples at the output rate are interpolated from those nodes with
+ * cubic Hermite segments, the range using the range rate as its derivative
+ * and the range rate using the range acceleration, so producing them
+ * involves no further propagation or look angles.
+ *
+ * The binary stream is a header of the four bytes "DOPP", the sample count
+ * as a uint32 and the downlink and uplink frequencies as float64, followed
+ * by one 24 byte record per sample: ticks as an int64, then the downlink
+ * offset, uplink offset, light time and range rate as float32. All fields
+ * are little endian.
+ */
+class DopplerTable
+{
+public:
+   /**
+    * Constructor
+    * @param[in] geo the observers position
+    * @param[in] sgp4 the propagator for the satellite, must outlive this object
+    * @param[in] downlink_frequency nominal downlink frequency in Hz
+    * @param[in] uplink_frequency nominal uplink frequency in Hz
+    */
+   DopplerTable( const CoordGeodetic& geo,
+                 const SGP4& sgp4,
+                 const double downlink_frequency,
+                 const double uplink_frequency )
+      : m_sgp4( sgp4 )
+      , m_observer( geo )
+      , m_downlink_frequency( downlink_frequency )
+      , m_uplink_frequency( uplink_frequency )
+   {
+   }
+
+   /**
+    * Propagate the coarse nodes for a span, replacing any previous span
+    * @param[in] start start of the span
+    * @param[in] end end of the span
+    * @param[in] coarse_step seconds between nodes
+    * @returns OK, or the status of the first node that could not be
+    * propagated, in which case the span is left empty
+    */
+   PropagationStatus Prepare( const DateTime& start,
+                              const DateTime& end,
+                              const int coarse_step = 10 );
+
+   /**
+    * @param[in] dt the time to check
+    * @returns whether dt is within the prepared span
+    */
+   bool Covers( const DateTime& dt ) const
+   {
+      return !m_nodes.empty() && dt.Ticks() >= m_start && dt.Ticks() <= m_end;
+   }
+
+   /**
+    * Interpolate the sample for a time, clamped to the prepared span
+    * @param[in] ticks the time of the sample
+    * @returns the sample
+    */
+   DopplerSample Interpolate( const int64_t ticks ) const;
+
+   /**
+    * Generate the samples for the whole prepared span
+    * @param[in] rate samples per second
+    * @param[out] samples receives the samples, in time order
+    */
+   void Generate( const double rate,
+                  std::vector<DopplerSample>& samples ) const;
+
+   /**
+    * Write the samples for the whole prepared span as CSV, one line of
+    * unix seconds, range, range rate, light time, downlink offset and uplink
+    * offset per sample
+    * @param[in] os the stream to write to
+    * @param[in] rate samples per second
+    * @returns the number of samples written
+    */
+   size_t WriteCsv( std::ostream& os, const double rate ) const;
+
+   /**
+    * Write the samples for the whole prepared span in the binary format
+    * @param[in] os the stream to write to, opened in binary mode
+    * @param[in] rate samples per second
+    * @returns the number of samples written
+    */
+   size_t WriteBinary( std::ostream& os, const double rate ) const;
+
+private:
+   struct Node
+   {
+      double range;
+      double range_rate;
+      double range_acceleration;
+   };
+
+   /**
+    * @param[in] dt the time of the node
+    * @param[out] node the range and its derivatives at dt, set when the
+    * status is OK
+    * @returns the propagation status
+    */
+   PropagationStatus Evaluate( const DateTime& dt, Node& node );
+
+   /**
+    * @param[in] rate samples per second
+    * @returns the number of samples over the prepared span
+    */
+   size_t SampleCount( const double rate ) const;
+
+   /**
+    * @param[in] i index of the sample
+    * @param[in] rate samples per second
+    * @returns the sample
+    */
+   DopplerSample Sample( const size_t i, const double rate ) const;
+
+   /** the propagator for the satellite */
+   const SGP4& m_sgp4;
+   /** the observer */
+   Observer m_observer;
+   /** nominal downlink frequency in Hz */
+   double m_downlink_frequency;
+   /** nominal uplink frequency in Hz */
+   double m_uplink_frequency;
+   /** ticks of the first node */
+   int64_t m_start{};
+   /** ticks of the end of the span */
+   int64_t m_end{};
+   /** ticks between nodes */
+   int64_t m_step{};
+   /** the nodes */
+   std::vector<Node> m_nodes;
+};
+
+} // namespace libsgp4
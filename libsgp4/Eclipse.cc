@@ -0,0 +1,141 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Eclipse.h"
+
+#include "Globals.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace libsgp4::Eclipse
+{
+
+namespace
+{
+/*
+ * the satellite is in shadow when it is behind the Earth and within one
+ * Earth radius of the Earth-Sun line
+ */
+inline double Cylindrical( const Vector& satellite,
+                           const double sun_x,
+                           const double sun_y,
+                           const double sun_z )
+{
+   const double along = satellite.x * sun_x
+                        + satellite.y * sun_y
+                        + satellite.z * sun_z;
+   const double perpendicular_sq = satellite.x * satellite.x
+                                   + satellite.y * satellite.y
+                                   + satellite.z * satellite.z
+                                   - along * along;
+   return ( along < 0.0 && perpendicular_sq < kXKMPER * kXKMPER ) ? 0.0 : 1.0;
+}
+
+/*
+ * compares the apparent radii of the Sun (a) and the Earth (b) with their
+ * apparent separation (c) as seen from the satellite
+ */
+inline double Conical( const Vector& satellite, const Vector& sun )
+{
+   const double dx = sun.x - satellite.x;
+   const double dy = sun.y - satellite.y;
+   const double dz = sun.z - satellite.z;
+   const double sun_distance = sqrt( dx * dx + dy * dy + dz * dz );
+   const double earth_distance = sqrt( satellite.x * satellite.x
+                                       + satellite.y * satellite.y
+                                       + satellite.z * satellite.z );
+
+   const double a = asin( std::min( 1.0, kSOLAR_RADIUS / sun_distance ) );
+   const double b = asin( std::min( 1.0, kXKMPER / earth_distance ) );
+   const double cos_c = -( satellite.x * dx + satellite.y * dy + satellite.z * dz )
+                        / ( earth_distance * sun_distance );
+   const double c = acos( std::max( -1.0, std::min( 1.0, cos_c ) ) );
+
+   if ( c >= a + b )
+   {
+      /*
+       * discs do not overlap
+       */
+      return 1.0;
+   }
+   if ( c <= b - a )
+   {
+      /*
+       * umbra, the Earth covers the whole Sun
+       */
+      return 0.0;
+   }
+   if ( c <= a - b )
+   {
+      /*
+       * annular, the Earth is inside the solar disc
+       */
+      return 1.0 - ( b * b ) / ( a * a );
+   }
+
+   /*
+    * penumbra, area of the overlapping circular segments
+    */
+   const double x = ( c * c + a * a - b * b ) / ( 2.0 * c );
+   const double y = sqrt( std::max( 0.0, a * a - x * x ) );
+   const double area = a * a * acos( std::max( -1.0, std::min( 1.0, x / a ) ) )
+                       + b * b * acos( std::max( -1.0, std::min( 1.0, ( c - x ) / b ) ) )
+                       - c * y;
+   return 1.0 - area / ( kPI * a * a );
+}
+}
+
+double Illumination( const Vector& satellite,
+                     const Vector& sun,
+                     ShadowModel model )
+{
+   double illumination;
+   Illumination( sun, &satellite, 1, &illumination, model );
+   return illumination;
+}
+
+void Illumination( const Vector& sun,
+                   const Vector* satellites,
+                   size_t count,
+                   double* illumination,
+                   ShadowModel model )
+{
+   if ( model == ShadowModel::CYLINDRICAL )
+   {
+      /*
+       * the shadow axis is shared by all satellites
+       */
+      const double sun_distance = sun.Magnitude();
+      const double sun_x = sun.x / sun_distance;
+      const double sun_y = sun.y / sun_distance;
+      const double sun_z = sun.z / sun_distance;
+      for ( size_t i = 0; i < count; i++ )
+      {
+         illumination[i] = Cylindrical( satellites[i], sun_x, sun_y, sun_z );
+      }
+   }
+   else
+   {
+      for ( size_t i = 0; i < count; i++ )
+      {
+         illumination[i] = Conical( satellites[i], sun );
+      }
+   }
+}
+
+} // namespace libsgp4::Eclipse
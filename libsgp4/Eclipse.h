@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "Vector.h"
+
+#include <cstddef>
+
+namespace libsgp4
+{
+
+/**
+ * @brief The shape of the Earth's shadow.
+ */
+enum class ShadowModel
+{
+   /** shadow is a cylinder of Earth radius, no penumbra */
+   CYLINDRICAL,
+   /** umbral and penumbral cones from the apparent solar disc */
+   CONICAL
+};
+
+namespace Eclipse
+{
+
+/**
+ * Find how much of the Sun is visible from a satellite
+ * @param[in] satellite Eci position of the satellite in km
+ * @param[in] sun Eci position of the Sun in km
+ * @param[in] model the shadow model
+ * @returns fraction of the solar disc visible, 0 in umbra and 1 when sunlit
+ */
+double Illumination( const Vector& satellite,
+                     const Vector& sun,
+                     ShadowModel model );
+
+/**
+ * Find how much of the Sun is visible from many satellites at one time, so
+ * the solar position is computed once and shared between them
+ * @param[in] sun Eci position of the Sun in km
+ * @param[in] satellites Eci positions of the satellites in km
+ * @param[in] count number of satellites
+ * @param[out] illumination fraction of the solar disc visible per satellite
+ * @param[in] model the shadow model
+ */
+void Illumination( const Vector& sun,
+                   const Vector* satellites,
+                   size_t count,
+                   double* illumination,
+                   ShadowModel model );
+
+} // namespace Eclipse
+} // namespace libsgp4
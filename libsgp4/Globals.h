@@ -67,6 +67,14 @@ const double kF = 1.0 / 298.26;
  */
 const double kOMEGA_E = 1.00273790934;
 const double kAU = 1.49597870691e8;
+/*
+ * mean solar radius in km
+ */
+const double kSOLAR_RADIUS = 6.96e5;
+/*
+ * speed of light in km/s
+ */
+const double kC = 299792.458;
 
 const double kSECONDS_PER_DAY = 86400.0;
 const double kMINUTES_PER_DAY = 1440.0;
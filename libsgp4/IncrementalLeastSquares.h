@@ -0,0 +1,283 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Linear least squares solved one observation at a time.
+ *
+ * Keeps the upper triangular factor R of the QR decomposition of the
+ * observations, with the rotated right hand side, and folds each new
+ * observation in with Givens rotations. Adding an observation costs O(N^2)
+ * and no observation is stored, yet the solution is the same as a batch QR
+ * over all of them.
+ *
+ * A forgetting factor below one scales down the information from earlier
+ * observations each time Forget is called, usually once per epoch of new
+ * observations, so the estimate follows slowly changing parameters.
+ *
+ * @tparam N the number of parameters
+ */
+template
+<size_t N>
+class IncrementalLeastSquares
+{
+public:
+   using Row = std::array<double, N>;
+   using Matrix = std::array<Row, N>;
+
+   /**
+    * Constructor
+    * @param[in] forgetting_factor weight kept by earlier observations each
+    * time Forget is called, in (0, 1]
+    */
+   explicit IncrementalLeastSquares( const double forgetting_factor = 1.0 )
+      : m_forgetting_factor( forgetting_factor )
+   {
+      Reset();
+   }
+
+   /**
+    * Discard all observations
+    */
+   void Reset()
+   {
+      for ( Row& row : m_r )
+      {
+         row.fill( 0.0 );
+      }
+      m_z.fill( 0.0 );
+      m_rss = 0.0;
+      m_weight = 0.0;
+      m_count = 0;
+   }
+
+   /**
+    * Scale down the weight of the observations added so far by the
+    * forgetting factor
+    */
+   void Forget()
+   {
+      if ( m_forgetting_factor >= 1.0 )
+      {
+         return;
+      }
+
+      const double scale = std::sqrt( m_forgetting_factor );
+      for ( size_t i = 0; i < N; i++ )
+      {
+         for ( size_t j = i; j < N; j++ )
+         {
+            m_r[i][j] *= scale;
+         }
+         m_z[i] *= scale;
+      }
+      m_rss *= m_forgetting_factor;
+      m_weight *= m_forgetting_factor;
+   }
+
+   /**
+    * Add an observation b = a . x
+    * @param[in] a the coefficients of the observation
+    * @param[in] b the observed value
+    * @param[in] weight the weight of the observation
+    */
+   void Add( const Row& a, const double b, const double weight = 1.0 )
+   {
+      const double w = std::sqrt( weight );
+      Row row;
+      for ( size_t j = 0; j < N; j++ )
+      {
+         row[j] = a[j] * w;
+      }
+      double rhs = b * w;
+
+      /*
+       * rotate the observation into R, zeroing one coefficient per row;
+       * what is left of the right hand side is its residual
+       */
+      for ( size_t k = 0; k < N; k++ )
+      {
+         if ( row[k] == 0.0 )
+         {
+            continue;
+         }
+
+         const double r = std::hypot( m_r[k][k], row[k] );
+         const double c = m_r[k][k] / r;
+         const double s = row[k] / r;
+
+         for ( size_t j = k; j < N; j++ )
+         {
+            const double t = m_r[k][j];
+            m_r[k][j] = c * t + s * row[j];
+            row[j] = c * row[j] - s * t;
+         }
+         const double t = m_z[k];
+         m_z[k] = c * t + s * rhs;
+         rhs = c * rhs - s * t;
+      }
+
+      m_rss += rhs * rhs;
+      m_weight += weight;
+      m_count++;
+   }
+
+   /**
+    * Solve for the parameters. Parameters the observations do not
+    * determine yet are returned as zero.
+    * @returns the least squares parameters
+    */
+   Row Solve() const
+   {
+      const double tolerance = Tolerance();
+      Row x;
+      for ( size_t k = N; k-- > 0; )
+      {
+         if ( std::fabs( m_r[k][k] ) <= tolerance )
+         {
+            x[k] = 0.0;
+            continue;
+         }
+         double sum = m_z[k];
+         for ( size_t j = k + 1; j < N; j++ )
+         {
+            sum -= m_r[k][j] * x[j];
+         }
+         x[k] = sum / m_r[k][k];
+      }
+      return x;
+   }
+
+   /**
+    * Get the covariance of the parameters, sigma^2 R^-1 R^-T, with sigma^2
+    * estimated from the residuals
+    * @param[out] covariance the covariance
+    * @returns false while there are too few observations, or some parameter
+    * is not determined
+    */
+   bool Covariance( Matrix& covariance ) const
+   {
+      if ( m_weight <= static_cast<double>( N ) )
+      {
+         return false;
+      }
+
+      const double tolerance = Tolerance();
+      for ( size_t k = 0; k < N; k++ )
+      {
+         if ( std::fabs( m_r[k][k] ) <= tolerance )
+         {
+            return false;
+         }
+      }
+
+      /*
+       * R^-1 is upper triangular, found column by column
+       */
+      Matrix r_inverse{};
+      for ( size_t c = 0; c < N; c++ )
+      {
+         for ( size_t k = c + 1; k-- > 0; )
+         {
+            double sum = k == c ? 1.0 : 0.0;
+            for ( size_t j = k + 1; j <= c; j++ )
+            {
+               sum -= m_r[k][j] * r_inverse[j][c];
+            }
+            r_inverse[k][c] = sum / m_r[k][k];
+         }
+      }
+
+      const double variance = m_rss / ( m_weight - static_cast<double>( N ) );
+      for ( size_t i = 0; i < N; i++ )
+      {
+         for ( size_t j = i; j < N; j++ )
+         {
+            double sum = 0.0;
+            for ( size_t k = j; k < N; k++ )
+            {
+               sum += r_inverse[i][k] * r_inverse[j][k];
+            }
+            covariance[i][j] = variance * sum;
+            covariance[j][i] = covariance[i][j];
+         }
+      }
+      return true;
+   }
+
+   /**
+    * @returns the weighted residual sum of squares
+    */
+   double ResidualSumOfSquares() const
+   {
+      return m_rss;
+   }
+
+   /**
+    * @returns the weighted RMS residual
+    */
+   double RmsResidual() const
+   {
+      return m_weight > 0.0 ? std::sqrt( m_rss / m_weight ) : 0.0;
+   }
+
+   /**
+    * @returns the number of observations added
+    */
+   size_t Count() const
+   {
+      return m_count;
+   }
+
+private:
+   /**
+    * @returns the size below which a diagonal element of R is taken as zero
+    */
+   double Tolerance() const
+   {
+      double largest = 0.0;
+      for ( size_t k = 0; k < N; k++ )
+      {
+         largest = std::max( largest, std::fabs( m_r[k][k] ) );
+      }
+      return largest * 1e-12;
+   }
+
+   /** weight kept by earlier observations each time Forget is called */
+   double m_forgetting_factor;
+   /** upper triangular factor */
+   Matrix m_r;
+   /** rotated right hand side */
+   Row m_z;
+   /** residual sum of squares */
+   double m_rss;
+   /** sum of the observation weights, after forgetting */
+   double m_weight;
+   /** number of observations added */
+   size_t m_count;
+};
+
+} // namespace libsgp4
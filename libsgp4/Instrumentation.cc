@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Instrumentation.h"
+
+#include <sstream>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * write the non-empty bins of a histogram
+ */
+void WriteBins( std::ostream& os, const Histogram& histogram )
+{
+   for ( size_t i = 0; i < Histogram::kBins; i++ )
+   {
+      if ( histogram.bins[i] != 0 )
+      {
+         os << " " << i << ":" << histogram.bins[i];
+      }
+   }
+   os << std::endl;
+}
+}
+
+uint64_t Histogram::Total() const
+{
+   uint64_t total = 0;
+   for ( const uint64_t count : bins )
+   {
+      total += count;
+   }
+   return total;
+}
+
+Histogram& Histogram::operator+=( const Histogram& other )
+{
+   for ( size_t i = 0; i < kBins; i++ )
+   {
+      bins[i] += other.bins[i];
+   }
+   return *this;
+}
+
+PropagationCounters& PropagationCounters::operator+=( const PropagationCounters& other )
+{
+   near_earth_calls += other.near_earth_calls;
+   simple_calls += other.simple_calls;
+   deep_space_calls += other.deep_space_calls;
+   kepler_unconverged += other.kepler_unconverged;
+   kepler_iterations += other.kepler_iterations;
+   integrator_restarts += other.integrator_restarts;
+   integrator_steps_total += other.integrator_steps_total;
+   integrator_steps += other.integrator_steps;
+   return *this;
+}
+
+std::string PropagationCounters::ToString() const
+{
+   std::stringstream ss;
+   ss << "Near earth calls:     " << near_earth_calls
+      << " (simple " << simple_calls << ")" << std::endl;
+   ss << "Deep space calls:     " << deep_space_calls << std::endl;
+   ss << "Kepler iterations:   ";
+   WriteBins( ss, kepler_iterations );
+   ss << "Kepler unconverged:   " << kepler_unconverged << std::endl;
+   ss << "Integrator restarts:  " << integrator_restarts << std::endl;
+   ss << "Integrator steps:     " << integrator_steps_total << std::endl;
+   ss << "Steps per call, log2:";
+   WriteBins( ss, integrator_steps );
+   return ss.str();
+}
+
+namespace Instrumentation
+{
+
+PropagationCounters Snapshot()
+{
+#ifdef SGP4_INSTRUMENTATION
+   return t_counters;
+#else
+   return PropagationCounters();
+#endif
+}
+
+void Reset()
+{
+#ifdef SGP4_INSTRUMENTATION
+   t_counters = PropagationCounters();
+#endif
+}
+
+} // namespace Instrumentation
+
+} // namespace libsgp4
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Counts of events in a range of bins.
+ */
+struct Histogram
+{
+   static const size_t kBins = 32;
+
+   /** counts per bin; values past the last bin are counted in it */
+   std::array<uint64_t, kBins> bins{};
+
+   /**
+    * Count one event
+    * @param[in] bin the bin of the event
+    */
+   void Add( const size_t bin )
+   {
+      bins[bin < kBins ? bin : kBins - 1]++;
+   }
+
+   /**
+    * @returns the number of events
+    */
+   uint64_t Total() const;
+
+   Histogram& operator+=( const Histogram& other );
+};
+
+/**
+ * @brief Counts of the work done by SGP4::FindPosition.
+ */
+struct PropagationCounters
+{
+   /** calls of the near earth model, including the simple model */
+   uint64_t near_earth_calls{};
+   /** calls of the near earth model that used the simple model */
+   uint64_t simple_calls{};
+   /** calls of the deep space model */
+   uint64_t deep_space_calls{};
+   /** Kepler solutions that did not converge within the iteration limit */
+   uint64_t kepler_unconverged{};
+   /** iterations of the Kepler solution, one event per call; solutions
+    * that did not converge in the 10 allowed are counted in bin 11 */
+   Histogram kepler_iterations;
+   /** resonant deep space calls that restarted the integrator at epoch */
+   uint64_t integrator_restarts{};
+   /** integrator steps walked in total */
+   uint64_t integrator_steps_total{};
+   /** integrator steps walked per resonant deep space call, in bins of
+    * Instrumentation::Log2Bin */
+   Histogram integrator_steps;
+
+   PropagationCounters& operator+=( const PropagationCounters& other );
+
+   /**
+    * Convert the counters to a readable string
+    * @returns the counters as a string
+    */
+   std::string ToString() const;
+};
+
+/**
+ * @brief Optional per-thread counters of the propagators hot paths.
+ *
+ * The counters exist when the library is built with SGP4_INSTRUMENTATION
+ * defined (the CMake option of the same name); otherwise the hooks compile
+ * to nothing and Snapshot returns zeros. Each thread counts into its own
+ * counters, so counting takes no locks; threads that need a total snapshot
+ * their own counters and add them up.
+ */
+namespace Instrumentation
+{
+
+#ifdef SGP4_INSTRUMENTATION
+const bool kEnabled = true;
+#else
+const bool kEnabled = false;
+#endif
+
+/**
+ * @returns a copy of the calling threads counters
+ */
+PropagationCounters Snapshot();
+
+/**
+ * Zero the calling threads counters
+ */
+void Reset();
+
+/**
+ * @param[in] value a count
+ * @returns 0 for 0, else k for a value in [2^(k-1), 2^k)
+ */
+inline size_t Log2Bin( uint64_t value )
+{
+   size_t bin = 0;
+   while ( value != 0 )
+   {
+      value >>= 1;
+      bin++;
+   }
+   return bin;
+}
+
+#ifdef SGP4_INSTRUMENTATION
+/** the calling threads counters */
+inline thread_local PropagationCounters t_counters;
+#endif
+
+} // namespace Instrumentation
+
+} // namespace libsgp4
+
+#ifdef SGP4_INSTRUMENTATION
+#define SGP4_INSTRUMENT( ... ) __VA_ARGS__
+#define SGP4_COUNT( field ) \
+   ( ++::libsgp4::Instrumentation::t_counters.field )
+#define SGP4_COUNT_ADD( field, value ) \
+   ( ::libsgp4::Instrumentation::t_counters.field += ( value ) )
+#define SGP4_HISTOGRAM( field, bin ) \
+   ( ::libsgp4::Instrumentation::t_counters.field.Add( bin ) )
+#else
+#define SGP4_INSTRUMENT( ... )
+#define SGP4_COUNT( field ) ( ( void ) 0 )
+#define SGP4_COUNT_ADD( field, value ) ( ( void ) 0 )
+#define SGP4_HISTOGRAM( field, bin ) ( ( void ) 0 )
+#endif
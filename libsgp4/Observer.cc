@@ -16,13 +16,100 @@
 
 #include "Observer.h"
 #include "CoordTopocentric.h"
+#include "Globals.h"
+#include "PointingModel.h"
+#include "RefractionModel.h"
+#include "Tracing.h"
+
+#include <cmath>
 
 namespace libsgp4 {
 
+namespace {
+/*
+ * iterations of the light time; each one shrinks the error by a factor of
+ * about v / c, so two leave well under a millimetre
+ */
+const int kLightTimeIterations = 2;
+} // namespace
+
 /*
  * calculate lookangle between the observer and the passed in Eci object
  */
 CoordTopocentric Observer::GetLookAngle(const Eci &eci) {
+  double top_s;
+  double top_e;
+  double top_z;
+  CoordTopocentric topo = LookAngle(eci, false, top_s, top_e, top_z);
+  if (m_refraction != nullptr) {
+    topo.m_elevation = m_refraction->Apparent(topo.m_elevation);
+  }
+  return topo;
+}
+
+void Observer::GetLookAngles(const Eci *eci, size_t count,
+                             CoordTopocentric *look_angles) {
+  SGP4_TRACE_SCOPE("Observer::GetLookAngles");
+  double top_s;
+  double top_e;
+  double top_z;
+  for (size_t i = 0; i < count; ++i) {
+    look_angles[i] = LookAngle(eci[i], m_light_time, top_s, top_e, top_z);
+    if (m_refraction != nullptr) {
+      look_angles[i].m_elevation =
+          m_refraction->Apparent(look_angles[i].m_elevation);
+    }
+  }
+}
+
+void Observer::GetLookAngles(const Eci *eci, size_t count,
+                             const PointingModel &model,
+                             CoordTopocentric *look_angles,
+                             CoordTopocentric *corrected) {
+  SGP4_TRACE_SCOPE("Observer::GetLookAngles/pointing_model");
+  double top_s;
+  double top_e;
+  double top_z;
+  for (size_t i = 0; i < count; ++i) {
+    CoordTopocentric topo =
+        LookAngle(eci[i], m_light_time, top_s, top_e, top_z);
+
+    /*
+     * sines and cosines of the look angle straight from the topocentric
+     * components
+     */
+    double horizontal = std::sqrt(top_s * top_s + top_e * top_e);
+    double sin_az = horizontal > 0.0 ? top_e / horizontal : 0.0;
+    double cos_az = horizontal > 0.0 ? -top_s / horizontal : 1.0;
+    double sin_el = top_z / topo.m_range;
+    double cos_el = horizontal / topo.m_range;
+
+    /*
+     * refraction is at most a hundredth of a radian, so the elevation is
+     * rotated by it with short series for its sine and cosine
+     */
+    if (m_refraction != nullptr) {
+      const double r = m_refraction->Refraction(topo.m_elevation);
+      const double sin_r = r - r * r * r / 6.0;
+      const double cos_r = 1.0 - r * r / 2.0;
+      const double sin_apparent = sin_el * cos_r + cos_el * sin_r;
+      cos_el = cos_el * cos_r - sin_el * sin_r;
+      sin_el = sin_apparent;
+      topo.m_elevation += r;
+    }
+    look_angles[i] = topo;
+
+    double az = topo.m_azimuth;
+    double el = topo.m_elevation;
+    model.Apply(sin_az, cos_az, sin_el, cos_el, az, el);
+    corrected[i] = CoordTopocentric(Util::WrapTwoPI(az), el, topo.m_range,
+                                    topo.m_range_rate);
+  }
+}
+
+CoordTopocentric Observer::LookAngle(const Eci &eci, bool light_time,
+                                     double &top_s, double &top_e,
+                                     double &top_z) {
   /*
    * update the observers Eci to match the time of the Eci passed in
    * if necessary
@@ -37,6 +124,23 @@ CoordTopocentric Observer::GetLookAngle(const Eci &eci) {
 
   range.w = range.Magnitude();
 
+  /*
+   * the signal received now left the satellite one light time ago, when it
+   * was first order back along its velocity; the observer stays where it
+   * is at reception
+   */
+  if (light_time) {
+    const Vector geometric = range;
+    const Vector velocity = eci.Velocity();
+    for (int i = 0; i < kLightTimeIterations; ++i) {
+      const double tau = range.w / kC;
+      range = Vector(geometric.x - velocity.x * tau,
+                     geometric.y - velocity.y * tau,
+                     geometric.z - velocity.z * tau);
+      range.w = range.Magnitude();
+    }
+  }
+
   /*
    * Calculate Local Mean Sidereal Time for observers longitude
    */
@@ -47,11 +151,11 @@ CoordTopocentric Observer::GetLookAngle(const Eci &eci) {
   double sin_theta = sin(theta);
   double cos_theta = cos(theta);
 
-  double top_s = sin_lat * cos_theta * range.x + sin_lat * sin_theta * range.y -
-                 cos_lat * range.z;
-  double top_e = -sin_theta * range.x + cos_theta * range.y;
-  double top_z = cos_lat * cos_theta * range.x + cos_lat * sin_theta * range.y +
-                 sin_lat * range.z;
+  top_s = sin_lat * cos_theta * range.x + sin_lat * sin_theta * range.y -
+          cos_lat * range.z;
+  top_e = -sin_theta * range.x + cos_theta * range.y;
+  top_z = cos_lat * cos_theta * range.x + cos_lat * sin_theta * range.y +
+          sin_lat * range.z;
   double az = atan(-top_e / top_s);
 
   if (top_s > 0.0) {
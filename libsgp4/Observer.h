@@ -20,11 +20,15 @@
 #include "CoordGeodetic.h"
 #include "Eci.h"
 
+#include <cstddef>
+
 namespace libsgp4
 {
 
 class DateTime;
 struct CoordTopocentric;
+struct PointingModel;
+class RefractionModel;
 
 /**
  * @brief Stores an observers location in Eci coordinates.
@@ -75,6 +79,38 @@ public:
       return m_geo;
    }
 
+   /**
+    * Select whether the batch look angles are corrected for light time. When
+    * enabled the satellite is placed where it was when the signal left it,
+    * moved back along its velocity by the one-way light time, which shifts
+    * the look angle by up to a few thousandths of a degree for MEO and GEO.
+    * GetLookAngle always returns the geometric look angle.
+    * @param[in] enabled whether to correct for light time
+    */
+   void SetLightTimeCorrection( const bool enabled )
+   {
+      m_light_time = enabled;
+   }
+
+   /**
+    * @returns whether the batch look angles are corrected for light time
+    */
+   bool LightTimeCorrection() const
+   {
+      return m_light_time;
+   }
+
+   /**
+    * Select a refraction model for the look angles. With a model the
+    * elevations are apparent rather than geometric.
+    * @param[in] model the model, must outlive its use here, or nullptr for
+    * geometric elevations
+    */
+   void SetRefraction( const RefractionModel* model )
+   {
+      m_refraction = model;
+   }
+
    /**
     * Get the look angle for the observers position to the object
     * @param[in] eci the object to find the look angle to
@@ -82,7 +118,51 @@ public:
     */
    CoordTopocentric GetLookAngle( const Eci &eci );
 
+   /**
+    * Get the look angles for the observers position to a batch of objects,
+    * corrected for light time if selected
+    * @param[in] eci the objects to find the look angles to
+    * @param[in] count the number of objects
+    * @param[out] look_angles receives count look angles
+    */
+   void GetLookAngles( const Eci* eci,
+                       size_t count,
+                       CoordTopocentric* look_angles );
+
+   /**
+    * Get the look angles for the observers position to a batch of objects,
+    * together with the look angles corrected by a mount pointing model. The
+    * corrections reuse the topocentric components of the look angles, so
+    * they cost no extra trigonometry. Both are corrected for light time if
+    * selected.
+    * @param[in] eci the objects to find the look angles to
+    * @param[in] count the number of objects
+    * @param[in] model the mount pointing model
+    * @param[out] look_angles receives count look angles
+    * @param[out] corrected receives count corrected look angles
+    */
+   void GetLookAngles( const Eci* eci,
+                       size_t count,
+                       const PointingModel& model,
+                       CoordTopocentric* look_angles,
+                       CoordTopocentric* corrected );
+
 private:
+   /**
+    * Get the look angle and its topocentric components
+    * @param[in] eci the object to find the look angle to
+    * @param[in] light_time whether to correct for light time
+    * @param[out] top_s range component towards south
+    * @param[out] top_e range component towards east
+    * @param[out] top_z range component towards the zenith
+    * @returns the look angle
+    */
+   CoordTopocentric LookAngle( const Eci &eci,
+                               bool light_time,
+                               double &top_s,
+                               double &top_e,
+                               double &top_z );
+
    /**
     * @param[in] dt the date to update the observers position for
     */
@@ -98,6 +178,10 @@ private:
    CoordGeodetic m_geo;
    /** the observers Eci for a particular time */
    Eci m_eci;
+   /** whether the batch look angles are corrected for light time */
+   bool m_light_time{};
+   /** refraction model for the elevations, if any */
+   const RefractionModel* m_refraction{};
 };
 
 } // namespace libsgp4
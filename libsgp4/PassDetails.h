@@ -0,0 +1,63 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "DateTime.h"
+
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief A part of a pass during which the satellite is sunlit.
+ */
+struct IlluminationInterval
+{
+   /** start of the interval */
+   DateTime start;
+   /** end of the interval */
+   DateTime end;
+   /**
+    * whether the observer is in darkness, i.e. the satellite is optically
+    * visible
+    */
+   bool observer_dark{};
+};
+
+/**
+ * @brief A single pass of a satellite over an observer.
+ */
+struct PassDetails
+{
+   /** acquisition of signal */
+   DateTime aos;
+   /** loss of signal */
+   DateTime los;
+   /** maximum elevation during the pass in radians */
+   double max_elevation{};
+   /** time of the maximum elevation (culmination) */
+   DateTime max_elevation_time;
+   /**
+    * sunlit parts of the pass, filled in by
+    * PassPredictor::ClassifyIllumination
+    */
+   std::vector<IlluminationInterval> sunlit;
+};
+
+} // namespace libsgp4
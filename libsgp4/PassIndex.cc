@@ -0,0 +1,195 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "PassIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace libsgp4
+{
+
+namespace
+{
+bool AosLess( const PassIndex::Entry& a, const PassIndex::Entry& b )
+{
+   return a.pass.aos.Ticks() < b.pass.aos.Ticks();
+}
+}
+
+void PassIndex::Replace( unsigned int satellite,
+                         const std::list<PassDetails>& passes )
+{
+   Remove( satellite );
+
+   for ( const auto& pass : passes )
+   {
+      Insert( satellite, pass );
+   }
+}
+
+void PassIndex::Insert( unsigned int satellite, const PassDetails& pass )
+{
+   m_pending.push_back( Entry{ satellite, pass } );
+   m_counts[satellite]++;
+   m_dirty = true;
+}
+
+void PassIndex::Remove( unsigned int satellite )
+{
+   auto count = m_counts.find( satellite );
+   if ( count == m_counts.end() )
+   {
+      /*
+       * nothing stored for this satellite, avoid scanning the index
+       */
+      return;
+   }
+
+   auto matches = [satellite]( const Entry & e )
+   {
+      return e.satellite == satellite;
+   };
+   /*
+    * remove_if keeps the relative order, so m_sorted stays sorted
+    */
+   m_sorted.erase( std::remove_if( m_sorted.begin(), m_sorted.end(), matches ),
+                   m_sorted.end() );
+   m_pending.erase( std::remove_if( m_pending.begin(), m_pending.end(), matches ),
+                    m_pending.end() );
+   m_counts.erase( count );
+   m_dirty = true;
+}
+
+void PassIndex::RemoveBefore( const DateTime& dt )
+{
+   auto expired = [this, &dt]( const Entry & e )
+   {
+      if ( e.pass.los < dt )
+      {
+         if ( --m_counts[e.satellite] == 0 )
+         {
+            m_counts.erase( e.satellite );
+         }
+         return true;
+      }
+      return false;
+   };
+   m_sorted.erase( std::remove_if( m_sorted.begin(), m_sorted.end(), expired ),
+                   m_sorted.end() );
+   m_pending.erase( std::remove_if( m_pending.begin(), m_pending.end(), expired ),
+                    m_pending.end() );
+   m_dirty = true;
+}
+
+std::vector<PassIndex::Entry> PassIndex::FindOverlapping(
+   const DateTime& start,
+   const DateTime& end ) const
+{
+   if ( m_dirty.load( std::memory_order_acquire ) )
+   {
+      std::lock_guard<std::mutex> lock( m_build_mutex );
+      if ( m_dirty.load( std::memory_order_relaxed ) )
+      {
+         Build();
+         m_dirty.store( false, std::memory_order_release );
+      }
+   }
+
+   std::vector<Entry> result;
+   Query( 0, m_sorted.size(), start.Ticks(), end.Ticks(), result );
+   return result;
+}
+
+void PassIndex::Build() const
+{
+   /*
+    * merge the staged entries into the sorted entries
+    */
+   if ( !m_pending.empty() )
+   {
+      std::sort( m_pending.begin(), m_pending.end(), AosLess );
+      const auto middle = static_cast<std::ptrdiff_t>( m_sorted.size() );
+      m_sorted.insert( m_sorted.end(), m_pending.begin(), m_pending.end() );
+      std::inplace_merge( m_sorted.begin(), m_sorted.begin() + middle,
+                          m_sorted.end(), AosLess );
+      m_pending.clear();
+   }
+
+   m_max_los.resize( m_sorted.size() );
+   BuildNode( 0, m_sorted.size() );
+}
+
+int64_t PassIndex::BuildNode( size_t lo, size_t hi ) const
+{
+   /*
+    * the node for the range [lo, hi) is at the middle, its children cover
+    * [lo, mid) and [mid + 1, hi)
+    */
+   if ( lo >= hi )
+   {
+      return std::numeric_limits<int64_t>::min();
+   }
+
+   const size_t mid = lo + ( hi - lo ) / 2;
+   const int64_t left = BuildNode( lo, mid );
+   const int64_t right = BuildNode( mid + 1, hi );
+   m_max_los[mid] = std::max( m_sorted[mid].pass.los.Ticks(),
+                              std::max( left, right ) );
+   return m_max_los[mid];
+}
+
+void PassIndex::Query( size_t lo,
+                       size_t hi,
+                       int64_t start,
+                       int64_t end,
+                       std::vector<Entry>& result ) const
+{
+   if ( lo >= hi )
+   {
+      return;
+   }
+
+   const size_t mid = lo + ( hi - lo ) / 2;
+   if ( m_max_los[mid] < start )
+   {
+      /*
+       * every pass in this subtree has ended before the period
+       */
+      return;
+   }
+
+   Query( lo, mid, start, end, result );
+
+   const Entry& entry = m_sorted[mid];
+   if ( entry.pass.aos.Ticks() > end )
+   {
+      /*
+       * this pass and the right subtree start after the period
+       */
+      return;
+   }
+
+   if ( entry.pass.los.Ticks() >= start )
+   {
+      result.push_back( entry );
+   }
+
+   Query( mid + 1, hi, start, end, result );
+}
+
+} // namespace libsgp4
@@ -0,0 +1,137 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "DateTime.h"
+#include "PassDetails.h"
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Time index over the predicted passes of many satellites for one
+ * observer.
+ *
+ * Passes are kept sorted by AOS in an implicit, augmented interval tree
+ * (each node of the implicit binary tree stores the latest LOS of its
+ * subtree), so overlap and point-in-time queries cost O(log n + k) for k
+ * results.
+ *
+ * Changes are staged and the tree is rebuilt on the next query. Queries may
+ * run concurrently with each other, but not with changes.
+ */
+class PassIndex
+{
+public:
+   /**
+    * @brief A pass stored in the index.
+    */
+   struct Entry
+   {
+      /** norad number of the satellite */
+      unsigned int satellite;
+      /** the pass */
+      PassDetails pass;
+   };
+
+   PassIndex() = default;
+
+   PassIndex( const PassIndex& ) = delete;
+   PassIndex& operator=( const PassIndex& ) = delete;
+
+   /**
+    * Replace all passes of a satellite, e.g. after a new Tle was received
+    * @param[in] satellite norad number of the satellite
+    * @param[in] passes the new passes
+    */
+   void Replace( unsigned int satellite, const std::list<PassDetails>& passes );
+
+   /**
+    * Add a single pass of a satellite
+    * @param[in] satellite norad number of the satellite
+    * @param[in] pass the pass to add
+    */
+   void Insert( unsigned int satellite, const PassDetails& pass );
+
+   /**
+    * Remove all passes of a satellite
+    * @param[in] satellite norad number of the satellite
+    */
+   void Remove( unsigned int satellite );
+
+   /**
+    * Remove all passes that ended before a time
+    * @param[in] dt passes with a LOS before this time are removed
+    */
+   void RemoveBefore( const DateTime& dt );
+
+   /**
+    * Find all passes that overlap a period of time
+    * @param[in] start start of the period
+    * @param[in] end end of the period
+    * @returns the passes with aos <= end and los >= start, in AOS order
+    */
+   std::vector<Entry> FindOverlapping( const DateTime& start,
+                                       const DateTime& end ) const;
+
+   /**
+    * Find all passes in progress at a given time
+    * @param[in] dt the time
+    * @returns the passes with aos <= dt <= los, in AOS order
+    */
+   std::vector<Entry> FindAt( const DateTime& dt ) const
+   {
+      return FindOverlapping( dt, dt );
+   }
+
+   /**
+    * @returns the number of passes stored
+    */
+   size_t Size() const
+   {
+      return m_sorted.size() + m_pending.size();
+   }
+
+private:
+   void Build() const;
+   int64_t BuildNode( size_t lo, size_t hi ) const;
+   void Query( size_t lo, size_t hi, int64_t start, int64_t end,
+               std::vector<Entry>& result ) const;
+
+   /** entries sorted by aos, laid out as an implicit binary tree */
+   mutable std::vector<Entry> m_sorted;
+   /** latest los in the subtree rooted at each index of m_sorted */
+   mutable std::vector<int64_t> m_max_los;
+   /** entries added since the last build */
+   mutable std::vector<Entry> m_pending;
+   /** number of entries held per satellite */
+   std::unordered_map<unsigned int, size_t> m_counts;
+   /** whether the tree must be rebuilt before the next query */
+   mutable std::atomic<bool> m_dirty{ false };
+   /** serialises lazy rebuilds between concurrent queries */
+   mutable std::mutex m_build_mutex;
+};
+
+} // namespace libsgp4
@@ -0,0 +1,819 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "PassPredictor.h"
+
+#include "CoordTopocentric.h"
+#include "Globals.h"
+#include "TimeSpan.h"
+#include "Tracing.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * spacing of the checkpoints at which the divergence between two
+ * propagators is sampled
+ */
+const TimeSpan kCheckpointSpacing( 6, 0, 0 );
+
+/*
+ * illumination state bits
+ */
+const int SUNLIT = 1;
+const int OBSERVER_DARK = 2;
+
+struct TimeRange
+{
+   DateTime start;
+   DateTime end;
+};
+
+bool SameElements( const OrbitalElements& a, const OrbitalElements& b )
+{
+   return a.Epoch() == b.Epoch()
+          && a.MeanAnomoly() == b.MeanAnomoly()
+          && a.AscendingNode() == b.AscendingNode()
+          && a.ArgumentPerigee() == b.ArgumentPerigee()
+          && a.Eccentricity() == b.Eccentricity()
+          && a.Inclination() == b.Inclination()
+          && a.MeanMotion() == b.MeanMotion()
+          && a.BStar() == b.BStar();
+}
+
+/*
+ * find the previous pass in progress at dt, if any
+ */
+const PassDetails* FindPass( const std::list<PassDetails>& passes,
+                             const DateTime& dt )
+{
+   for ( const auto& pass : passes )
+   {
+      if ( pass.aos <= dt && dt <= pass.los )
+      {
+         return &pass;
+      }
+   }
+   return nullptr;
+}
+
+/*
+ * a pass being classified, with its illumination states at the grid times
+ * first to last within it
+ */
+struct IlluminationTrack
+{
+   size_t satellite;
+   PassDetails* pass;
+   int64_t first;
+   int64_t last;
+   std::vector<int> states;
+};
+
+/*
+ * the illumination state at dt, a combination of the SUNLIT and
+ * OBSERVER_DARK bits
+ */
+int IlluminationState( const SGP4& sgp4,
+                       Observer& observer,
+                       const DateTime& dt,
+                       const SolarEphemeris& ephemeris,
+                       const ShadowModel model,
+                       const double twilight_elevation )
+{
+   const Eci sun = ephemeris.FindPosition( dt );
+   Eci eci( dt, Vector() );
+
+   int state = 0;
+   if ( sgp4.Propagate( dt, eci ) == PropagationStatus::OK
+         && Eclipse::Illumination( eci.Position(), sun.Position(), model ) > 0.0 )
+   {
+      state |= SUNLIT;
+   }
+   if ( observer.GetLookAngle( sun ).m_elevation < twilight_elevation )
+   {
+      state |= OBSERVER_DARK;
+   }
+   return state;
+}
+}
+
+double PassPredictor::Elevation( const DateTime& dt )
+{
+   Eci eci( dt, Vector() );
+   if ( m_sgp4.Propagate( dt, eci ) != PropagationStatus::OK )
+   {
+      return -kPI / 2.0;
+   }
+   const double elevation = m_observer.GetLookAngle( eci ).m_elevation;
+   return m_refraction == nullptr ? elevation : m_refraction->Apparent( elevation );
+}
+
+void PassPredictor::ClassifyIllumination( std::list<PassDetails>& passes,
+      const int time_step,
+      const ShadowModel model,
+      const double twilight_elevation )
+{
+   ClassifyIllumination( m_observer.GetLocation(), { &m_sgp4 }, { &passes },
+                         time_step, model, twilight_elevation );
+}
+
+void PassPredictor::ClassifyIllumination( const CoordGeodetic& geo,
+      const std::vector<const SGP4*>& satellites,
+      const std::vector<std::list<PassDetails>*>& passes,
+      const int time_step,
+      const ShadowModel model,
+      const double twilight_elevation )
+{
+   SGP4_TRACE_SCOPE( "PassPredictor::ClassifyIllumination" );
+
+   std::vector<IlluminationTrack> tracks;
+   int64_t first_aos = std::numeric_limits<int64_t>::max();
+   int64_t last_los = std::numeric_limits<int64_t>::min();
+   for ( size_t i = 0; i < satellites.size(); i++ )
+   {
+      for ( auto& pass : *passes[i] )
+      {
+         pass.sunlit.clear();
+         tracks.push_back( IlluminationTrack{ i, &pass, 0, 0, {} } );
+         first_aos = std::min( first_aos, pass.aos.Ticks() );
+         last_los = std::max( last_los, pass.los.Ticks() );
+      }
+   }
+
+   if ( tracks.empty() )
+   {
+      return;
+   }
+
+   Observer observer( geo );
+   const auto ephemeris = SolarEphemeris::Shared( DateTime( first_aos ),
+                          DateTime( last_los ) );
+
+   /*
+    * every satellite is sampled on one grid from the earliest AOS, so each
+    * grid time needs one Sun position and one darkness test whatever the
+    * number of satellites in a pass then
+    */
+   const int64_t step = TimeSpan( 0, 0, time_step ).Ticks();
+   for ( auto& track : tracks )
+   {
+      track.first = ( track.pass->aos.Ticks() - first_aos + step - 1 ) / step;
+      track.last = ( track.pass->los.Ticks() - first_aos ) / step;
+   }
+   std::sort( tracks.begin(), tracks.end(),
+              []( const IlluminationTrack& a, const IlluminationTrack& b )
+   {
+      return a.first < b.first;
+   } );
+
+   /*
+    * sweep the grid, skipping the times with no satellite in a pass
+    */
+   std::vector<IlluminationTrack*> active;
+   std::vector<IlluminationTrack*> propagated;
+   std::vector<Vector> positions;
+   std::vector<double> illumination;
+   size_t next = 0;
+   int64_t k = tracks.front().first;
+   while ( next < tracks.size() || !active.empty() )
+   {
+      if ( active.empty() )
+      {
+         k = std::max( k, tracks[next].first );
+      }
+      while ( next < tracks.size() && tracks[next].first <= k )
+      {
+         if ( tracks[next].first <= tracks[next].last )
+         {
+            active.push_back( &tracks[next] );
+         }
+         next++;
+      }
+      if ( active.empty() )
+      {
+         continue;
+      }
+
+      const DateTime t( first_aos + k * step );
+      const Eci sun = ephemeris->FindPosition( t );
+      const int dark = observer.GetLookAngle( sun ).m_elevation < twilight_elevation
+                       ? OBSERVER_DARK : 0;
+
+      positions.clear();
+      propagated.clear();
+      for ( auto* track : active )
+      {
+         track->states.push_back( dark );
+         Eci eci( t, Vector() );
+         if ( satellites[track->satellite]->Propagate( t, eci ) == PropagationStatus::OK )
+         {
+            positions.push_back( eci.Position() );
+            propagated.push_back( track );
+         }
+      }
+      illumination.resize( positions.size() );
+      Eclipse::Illumination( sun.Position(), positions.data(), positions.size(),
+                             illumination.data(), model );
+
+      for ( size_t i = 0; i < propagated.size(); i++ )
+      {
+         if ( illumination[i] > 0.0 )
+         {
+            propagated[i]->states.back() |= SUNLIT;
+         }
+      }
+
+      k++;
+      active.erase( std::remove_if( active.begin(), active.end(),
+                                    [k]( const IlluminationTrack* track )
+      {
+         return track->last < k;
+      } ), active.end() );
+   }
+
+   /*
+    * walk each pass from AOS over its grid times to LOS, refining every
+    * change of state to within a second
+    */
+   for ( const auto& track : tracks )
+   {
+      const SGP4& sgp4 = *satellites[track.satellite];
+      PassDetails& pass = *track.pass;
+
+      auto state_at = [&]( const DateTime& dt )
+      {
+         return IlluminationState( sgp4, observer, dt, *ephemeris, model,
+                                   twilight_elevation );
+      };
+
+      DateTime current_time( pass.aos );
+      DateTime interval_start( pass.aos );
+      int state = state_at( current_time );
+
+      for ( size_t j = 0; j <= track.states.size(); j++ )
+      {
+         DateTime next_time;
+         int next_state;
+         if ( j < track.states.size() )
+         {
+            next_time = DateTime( first_aos + ( track.first + static_cast<int64_t>( j ) ) * step );
+            next_state = track.states[j];
+         }
+         else
+         {
+            next_time = pass.los;
+            next_state = state_at( next_time );
+         }
+         if ( next_time <= current_time )
+         {
+            continue;
+         }
+
+         /*
+          * bisect for the first time with a new state, and again from there
+          * until the state at the end of the step is reached, so that a step
+          * with two changes, to a state that differs from both its ends, has
+          * both found
+          */
+         while ( state != next_state )
+         {
+            DateTime time1( current_time );
+            DateTime time2( next_time );
+            int state2 = next_state;
+            while ( ( time2 - time1 ).TotalSeconds() > 1.0 )
+            {
+               const DateTime middle_time = time1.AddSeconds(
+                                               ( time2 - time1 ).TotalSeconds() / 2.0 );
+               const int middle_state = state_at( middle_time );
+               if ( middle_state == state )
+               {
+                  time1 = middle_time;
+               }
+               else
+               {
+                  time2 = middle_time;
+                  state2 = middle_state;
+               }
+            }
+
+            if ( state & SUNLIT )
+            {
+               pass.sunlit.push_back( IlluminationInterval{ interval_start,
+                                      time2,
+                                      ( state & OBSERVER_DARK ) != 0 } );
+            }
+            interval_start = time2;
+            current_time = time2;
+            state = state2;
+         }
+
+         current_time = next_time;
+      }
+
+      if ( ( state & SUNLIT ) && interval_start < pass.los )
+      {
+         pass.sunlit.push_back( IlluminationInterval{ interval_start,
+                                pass.los,
+                                ( state & OBSERVER_DARK ) != 0 } );
+      }
+   }
+}
+
+double PassPredictor::EstimateTimingError( const SGP4& previous_sgp4,
+      const DateTime& dt ) const
+{
+   /*
+    * sample one revolution, so the once per revolution differences caused
+    * by eccentricity and argument of perigee are covered as well as the
+    * secular drift
+    */
+   const double quarter_period = m_sgp4.GetOrbitalElements().Period() / 4.0;
+   double error = 0.0;
+
+   for ( int i = 0; i < 4; i++ )
+   {
+      const DateTime t = dt.AddMinutes( quarter_period * i );
+      Eci current( t, Vector() );
+      Eci previous( t, Vector() );
+      if ( m_sgp4.Propagate( t, current ) != PropagationStatus::OK
+            || previous_sgp4.Propagate( t, previous ) != PropagationStatus::OK )
+      {
+         /*
+          * either satellite may have decayed, so search again
+          */
+         return std::numeric_limits<double>::infinity();
+      }
+      /*
+       * treat the whole position difference as along track. This is an
+       * estimate, not a bound: near a grazing pass a cross track difference
+       * moves the crossings by more than the along track time it amounts to
+       */
+      const double divergence = ( current.Position()
+                                  - previous.Position() ).Magnitude();
+      error = std::max( error, divergence / current.Velocity().Magnitude() );
+   }
+
+   return error;
+}
+
+std::list<PassDetails> PassPredictor::UpdatePassList(
+   const std::list<PassDetails>& previous_passes,
+   const SGP4& previous_sgp4,
+   const DateTime& start_time,
+   const DateTime& end_time,
+   const int time_step,
+   const double tolerance )
+{
+   SGP4_TRACE_SCOPE( "PassPredictor::UpdatePassList" );
+
+   if ( SameElements( previous_sgp4.GetOrbitalElements(),
+                      m_sgp4.GetOrbitalElements() ) )
+   {
+      return previous_passes;
+   }
+
+   /*
+    * sample the timing error at regular checkpoints over the period
+    */
+   std::vector<DateTime> checkpoints;
+   std::vector<double> errors;
+   for ( DateTime t = start_time; ; t = t + kCheckpointSpacing )
+   {
+      if ( t >= end_time )
+      {
+         checkpoints.push_back( end_time );
+         errors.push_back( EstimateTimingError( previous_sgp4, end_time ) );
+         break;
+      }
+      checkpoints.push_back( t );
+      errors.push_back( EstimateTimingError( previous_sgp4, t ) );
+   }
+
+   /*
+    * mark the ranges between checkpoints where passes could have moved by
+    * more than the tolerance, joining neighbouring ranges
+    */
+   std::vector<TimeRange> dirty;
+   for ( size_t i = 0; i + 1 < checkpoints.size(); i++ )
+   {
+      if ( std::max( errors[i], errors[i + 1] ) <= tolerance )
+      {
+         continue;
+      }
+      if ( !dirty.empty() && dirty.back().end == checkpoints[i] )
+      {
+         dirty.back().end = checkpoints[i + 1];
+      }
+      else
+      {
+         dirty.push_back( TimeRange{ checkpoints[i], checkpoints[i + 1] } );
+      }
+   }
+
+   if ( dirty.empty() )
+   {
+      return previous_passes;
+   }
+
+   const TimeSpan step( 0, 0, time_step );
+
+   /*
+    * move the range boundaries outwards until neither the previous nor the
+    * current propagator has the satellite above the horizon there, so no
+    * pass is split between a reused and a searched range
+    */
+   for ( auto& range : dirty )
+   {
+      while ( range.start > start_time )
+      {
+         const PassDetails* pass = FindPass( previous_passes, range.start );
+         if ( pass != nullptr )
+         {
+            range.start = pass->aos - step;
+         }
+         else if ( Elevation( range.start ) > 0.0 )
+         {
+            range.start = range.start - step;
+         }
+         else
+         {
+            break;
+         }
+         range.start = std::max( range.start, start_time );
+      }
+
+      while ( range.end < end_time )
+      {
+         const PassDetails* pass = FindPass( previous_passes, range.end );
+         if ( pass != nullptr )
+         {
+            range.end = pass->los + step;
+         }
+         else if ( Elevation( range.end ) > 0.0 )
+         {
+            range.end = range.end + step;
+         }
+         else
+         {
+            break;
+         }
+         range.end = std::min( range.end, end_time );
+      }
+   }
+
+   /*
+    * widening may have made ranges overlap
+    */
+   std::vector<TimeRange> merged;
+   for ( const auto& range : dirty )
+   {
+      if ( !merged.empty() && range.start <= merged.back().end )
+      {
+         merged.back().end = std::max( merged.back().end, range.end );
+      }
+      else
+      {
+         merged.push_back( range );
+      }
+   }
+
+   /*
+    * reuse the previous passes outside the ranges, search the ranges again
+    */
+   std::list<PassDetails> pass_list;
+   for ( const auto& pass : previous_passes )
+   {
+      bool reuse = true;
+      for ( const auto& range : merged )
+      {
+         if ( pass.aos <= range.end && pass.los >= range.start )
+         {
+            reuse = false;
+            break;
+         }
+      }
+      if ( reuse )
+      {
+         pass_list.push_back( pass );
+      }
+   }
+
+   for ( const auto& range : merged )
+   {
+      pass_list.splice( pass_list.end(),
+                        GeneratePassList( range.start, range.end, time_step ) );
+   }
+
+   pass_list.sort( []( const PassDetails & a, const PassDetails & b )
+   {
+      return a.aos < b.aos;
+   } );
+
+   return pass_list;
+}
+
+double PassPredictor::FindMaxElevation( const DateTime& aos,
+                                        const DateTime& los,
+                                        DateTime* max_elevation_time )
+{
+   SGP4_TRACE_SCOPE( "PassPredictor::FindMaxElevation" );
+
+   bool running;
+
+   double time_step = ( los - aos ).TotalSeconds() / 9.0;
+   DateTime current_time( aos ); //! current time
+   DateTime time1( aos );        //! start time of search period
+   DateTime time2( los );        //! end time of search period
+   double max_elevation;         //! max elevation
+   DateTime max_time( aos );     //! time of max elevation
+
+   do
+   {
+      running = true;
+      max_elevation = -99999999999999.0;
+      while ( running && current_time < time2 )
+      {
+         /*
+          * find position
+          */
+         const double elevation = Elevation( current_time );
+
+         if ( elevation > max_elevation )
+         {
+            /*
+             * still going up
+             */
+            max_elevation = elevation;
+            max_time = current_time;
+            /*
+             * move time along
+             */
+            current_time = current_time.AddSeconds( time_step );
+            if ( current_time > time2 )
+            {
+               /*
+                * dont go past end time
+                */
+               current_time = time2;
+            }
+         }
+         else
+         {
+            /*
+             * stop
+             */
+            running = false;
+         }
+      }
+
+      /*
+       * make start time to 2 time steps back
+       */
+      time1 = current_time.AddSeconds( -2.0 * time_step );
+      /*
+       * make end time to current time
+       */
+      time2 = current_time;
+      /*
+       * current time to start time
+       */
+      current_time = time1;
+      /*
+       * recalculate time step
+       */
+      time_step = ( time2 - time1 ).TotalSeconds() / 9.0;
+   }
+   while ( time_step > 1.0 );
+
+   if ( max_elevation_time != nullptr )
+   {
+      *max_elevation_time = max_time;
+   }
+
+   return max_elevation;
+}
+
+DateTime PassPredictor::FindCrossingPoint( const DateTime& initial_time1,
+      const DateTime& initial_time2,
+      bool finding_aos )
+{
+   SGP4_TRACE_SCOPE( "PassPredictor::FindCrossingPoint" );
+
+   bool running;
+   int cnt;
+
+   DateTime time1( initial_time1 );
+   DateTime time2( initial_time2 );
+   DateTime middle_time;
+
+   running = true;
+   cnt = 0;
+   while ( running && cnt++ < 16 )
+   {
+      middle_time = time1.AddSeconds( ( time2 - time1 ).TotalSeconds() / 2.0 );
+      /*
+       * calculate satellite position
+       */
+      if ( Elevation( middle_time ) > 0.0 )
+      {
+         /*
+          * satellite above horizon
+          */
+         if ( finding_aos )
+         {
+            time2 = middle_time;
+         }
+         else
+         {
+            time1 = middle_time;
+         }
+      }
+      else
+      {
+         if ( finding_aos )
+         {
+            time1 = middle_time;
+         }
+         else
+         {
+            time2 = middle_time;
+         }
+      }
+
+      if ( ( time2 - time1 ).TotalSeconds() < 1.0 )
+      {
+         /*
+          * two times are within a second, stop
+          */
+         running = false;
+         /*
+          * remove microseconds
+          */
+         int us = middle_time.Microsecond();
+         middle_time = middle_time.AddMicroseconds( -us );
+         /*
+          * step back into the pass by 1 second
+          */
+         middle_time = middle_time.AddSeconds( finding_aos ? 1 : -1 );
+      }
+   }
+
+   /*
+    * go back/forward 1second until below the horizon
+    */
+   running = true;
+   cnt = 0;
+   while ( running && cnt++ < 6 )
+   {
+      if ( Elevation( middle_time ) > 0 )
+      {
+         middle_time = middle_time.AddSeconds( finding_aos ? -1 : 1 );
+      }
+      else
+      {
+         running = false;
+      }
+   }
+
+   return middle_time;
+}
+
+std::list<PassDetails> PassPredictor::GeneratePassList(
+   const DateTime& start_time,
+   const DateTime& end_time,
+   const int time_step )
+{
+   SGP4_TRACE_SCOPE( "PassPredictor::GeneratePassList" );
+
+   std::list<PassDetails> pass_list;
+
+   DateTime aos_time;
+   DateTime los_time;
+
+   bool found_aos = false;
+
+   DateTime previous_time( start_time );
+   DateTime current_time( start_time );
+
+   while ( current_time < end_time )
+   {
+      bool end_of_pass = false;
+
+      /*
+       * calculate satellite position
+       */
+      const double elevation = Elevation( current_time );
+
+      if ( !found_aos && elevation > 0.0 )
+      {
+         /*
+          * aos hasnt occured yet, but the satellite is now above horizon
+          * this must have occured within the last time_step
+          */
+         if ( start_time == current_time )
+         {
+            /*
+             * satellite was already above the horizon at the start,
+             * so use the start time
+             */
+            aos_time = start_time;
+         }
+         else
+         {
+            /*
+             * find the point at which the satellite crossed the horizon
+             */
+            aos_time = FindCrossingPoint( previous_time, current_time, true );
+         }
+         found_aos = true;
+      }
+      else if ( found_aos && elevation < 0.0 )
+      {
+         found_aos = false;
+         /*
+          * end of pass, so move along more than time_step
+          */
+         end_of_pass = true;
+         /*
+          * already have the aos, but now the satellite is below the horizon,
+          * so find the los
+          */
+         los_time = FindCrossingPoint( previous_time, current_time, false );
+
+         PassDetails pd;
+         pd.aos = aos_time;
+         pd.los = los_time;
+         pd.max_elevation = FindMaxElevation( aos_time, los_time,
+                                              &pd.max_elevation_time );
+
+         pass_list.push_back( pd );
+      }
+
+      /*
+       * save current time
+       */
+      previous_time = current_time;
+
+      if ( end_of_pass )
+      {
+         /*
+          * at the end of the pass move the time along by 30mins
+          */
+         current_time = current_time + TimeSpan( 0, 30, 0 );
+      }
+      else
+      {
+         /*
+          * move the time along by the time step value
+          */
+         current_time = current_time + TimeSpan( 0, 0, time_step );
+      }
+
+      if ( current_time > end_time )
+      {
+         /*
+          * dont go past end time
+          */
+         current_time = end_time;
+      }
+   }
+
+   if ( found_aos )
+   {
+      /*
+       * satellite still above horizon at end of search period, so use end
+       * time as los
+       */
+      PassDetails pd;
+      pd.aos = aos_time;
+      pd.los = end_time;
+      pd.max_elevation = FindMaxElevation( aos_time, end_time,
+                                           &pd.max_elevation_time );
+      pass_list.push_back( pd );
+   }
+
+   return pass_list;
+}
+
+} // namespace libsgp4
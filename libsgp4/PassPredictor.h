@@ -0,0 +1,197 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "CoordGeodetic.h"
+#include "DateTime.h"
+#include "Eclipse.h"
+#include "Observer.h"
+#include "PassDetails.h"
+#include "RefractionModel.h"
+#include "SGP4.h"
+#include "SolarEphemeris.h"
+
+#include <list>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Searches for the passes of a satellite over an observer.
+ *
+ * A pass starts when the satellite rises above the horizon (AOS) and ends
+ * when it sets again (LOS). The satellite is propagated with
+ * SGP4::Propagate; at times it cannot be propagated, e.g. once it has
+ * decayed, it is taken to be below the horizon and in shadow.
+ */
+class PassPredictor
+{
+public:
+   /**
+    * Constructor
+    * @param[in] geo the observers position
+    * @param[in] sgp4 the propagator for the satellite, must outlive this object
+    */
+   PassPredictor( const CoordGeodetic& geo, const SGP4& sgp4 )
+      : m_sgp4( sgp4 )
+      , m_observer( geo )
+   {
+   }
+
+   /**
+    * Select a refraction model for the pass search. With a model AOS, LOS
+    * and the maximum elevation are for the apparent rather than the
+    * geometric elevation; the twilight test is unaffected.
+    * @param[in] model the model, must outlive its use here, or nullptr for
+    * geometric elevations
+    */
+   void SetRefraction( const RefractionModel* model )
+   {
+      m_refraction = model;
+   }
+
+   /**
+    * Generate the list of passes between two times
+    * @param[in] start_time start of the search period
+    * @param[in] end_time end of the search period
+    * @param[in] time_step coarse search step in seconds
+    * @returns the passes found, in time order
+    */
+   std::list<PassDetails> GeneratePassList( const DateTime& start_time,
+         const DateTime& end_time,
+         const int time_step );
+
+   /**
+    * Regenerate a pass list after the satellites Tle has been updated.
+    *
+    * The divergence between the previous and the current propagator is
+    * sampled over the search period. Previous passes are reused where the
+    * estimated timing error that divergence causes stays within the
+    * tolerance, and only the remaining time ranges are searched again. The
+    * estimate takes the divergence as along track, so the AOS/LOS of
+    * grazing passes may move by more than the tolerance.
+    *
+    * @param[in] previous_passes passes generated over the same period with
+    * the previous propagator
+    * @param[in] previous_sgp4 the propagator for the previous Tle
+    * @param[in] start_time start of the search period
+    * @param[in] end_time end of the search period
+    * @param[in] time_step coarse search step in seconds
+    * @param[in] tolerance the largest AOS/LOS shift in seconds for which a
+    * previous pass is reused
+    * @returns the passes found, in time order
+    */
+   std::list<PassDetails> UpdatePassList(
+      const std::list<PassDetails>& previous_passes,
+      const SGP4& previous_sgp4,
+      const DateTime& start_time,
+      const DateTime& end_time,
+      const int time_step,
+      const double tolerance );
+
+   /**
+    * Find the sunlit parts of each pass and whether the observer is in
+    * darkness during them, filling in PassDetails::sunlit.
+    *
+    * The Sun's position is looked up once per sample in the shared
+    * SolarEphemeris, and used for both the shadow and the observer darkness
+    * tests. Transitions are refined to within a second. A state that begins
+    * and ends between two samples, with the same state at both, is not
+    * seen: the shortest interval that is resolved is one time_step.
+    *
+    * @param[in,out] passes the passes to classify
+    * @param[in] time_step sampling step in seconds
+    * @param[in] model the shadow model
+    * @param[in] twilight_elevation the solar elevation in radians below
+    * which the observer is in darkness
+    */
+   void ClassifyIllumination( std::list<PassDetails>& passes,
+                              const int time_step,
+                              const ShadowModel model = ShadowModel::CONICAL,
+                              const double twilight_elevation = Util::DegreesToRadians( -6.0 ) );
+
+   /**
+    * Find the sunlit parts of the passes of many satellites over one
+    * observer, as ClassifyIllumination does for one.
+    *
+    * All the satellites are sampled on one grid, so the Sun's position and
+    * the observer darkness are found once per sample time and shared, and
+    * the shadow of every satellite in a pass at that time is found in one
+    * Eclipse::Illumination batch.
+    *
+    * @param[in] geo the observers position
+    * @param[in] satellites the propagator of each satellite
+    * @param[in,out] passes the passes of each satellite to classify
+    * @param[in] time_step sampling step in seconds
+    * @param[in] model the shadow model
+    * @param[in] twilight_elevation the solar elevation in radians below
+    * which the observer is in darkness
+    */
+   static void ClassifyIllumination( const CoordGeodetic& geo,
+                                     const std::vector<const SGP4*>& satellites,
+                                     const std::vector<std::list<PassDetails>*>& passes,
+                                     const int time_step,
+                                     const ShadowModel model = ShadowModel::CONICAL,
+                                     const double twilight_elevation = Util::DegreesToRadians( -6.0 ) );
+
+   /**
+    * Find the maximum elevation between aos and los
+    * @param[in] aos acquisition of signal
+    * @param[in] los loss of signal
+    * @param[out] max_elevation_time if not null, set to the time of the
+    * maximum elevation
+    * @returns the maximum elevation in radians
+    */
+   double FindMaxElevation( const DateTime& aos,
+                            const DateTime& los,
+                            DateTime* max_elevation_time = nullptr );
+
+   /**
+    * Find the time at which the satellite crosses the horizon
+    * @param[in] initial_time1 a time on one side of the crossing
+    * @param[in] initial_time2 a time on the other side of the crossing
+    * @param[in] finding_aos whether the satellite is rising
+    * @returns the crossing time to the nearest second
+    */
+   DateTime FindCrossingPoint( const DateTime& initial_time1,
+                               const DateTime& initial_time2,
+                               bool finding_aos );
+
+private:
+   /**
+    * @returns the elevation of the satellite at dt in radians
+    */
+   double Elevation( const DateTime& dt );
+
+   /**
+    * @returns an estimate in seconds of the AOS/LOS shift that the
+    * divergence between the two propagators causes around dt; it may be
+    * exceeded near grazing passes
+    */
+   double EstimateTimingError( const SGP4& previous_sgp4, const DateTime& dt ) const;
+
+   /** the satellite propagator */
+   const SGP4& m_sgp4;
+   /** the observer used for look angles */
+   Observer m_observer;
+   /** refraction model for the pass search, if any */
+   const RefractionModel* m_refraction{};
+};
+
+} // namespace libsgp4
@@ -0,0 +1,44 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace libsgp4
+{
+
+/**
+ * @brief A time-tagged antenna pointing command.
+ *
+ * Angles are in radians and rates in radians per second.
+ */
+struct PointingCommand
+{
+   /** time of the command in DateTime ticks */
+   int64_t ticks;
+   /** azimuth in radians */
+   double azimuth;
+   /** elevation in radians */
+   double elevation;
+   /** azimuth rate in radians per second */
+   double azimuth_rate;
+   /** elevation rate in radians per second */
+   double elevation_rate;
+};
+
+} // namespace libsgp4
@@ -0,0 +1,141 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "PointingModel.h"
+
+#include "Util.h"
+
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace libsgp4
+{
+
+PointingModel PointingModel::FromFile( const std::string& filename )
+{
+   std::ifstream file( filename );
+   if ( !file.is_open() )
+   {
+      throw std::runtime_error( "Cannot open pointing model " + filename );
+   }
+   return FromStream( file );
+}
+
+PointingModel PointingModel::FromStream( std::istream& stream )
+{
+   PointingModel model;
+   std::string line;
+
+   while ( std::getline( stream, line ) )
+   {
+      Util::Trim( line );
+      if ( line.empty() || line[0] == '#' )
+      {
+         continue;
+      }
+
+      std::istringstream ss( line );
+      std::string key;
+      double value;
+      if ( !( ss >> key >> value ) )
+      {
+         throw std::runtime_error( "Invalid pointing model line: " + line );
+      }
+
+      if ( key == "AZ0" )
+      {
+         model.az0 = value;
+      }
+      else if ( key == "AN" )
+      {
+         model.an = value;
+      }
+      else if ( key == "AC" )
+      {
+         model.ac = value;
+      }
+      else if ( key == "COLL" )
+      {
+         model.coll = value;
+      }
+      else if ( key == "EL0" )
+      {
+         model.el0 = value;
+      }
+      else if ( key == "GRAV" )
+      {
+         model.grav = value;
+      }
+      else if ( key == "EL_LIN" )
+      {
+         model.el_lin = value;
+      }
+      else
+      {
+         throw std::runtime_error( "Unknown pointing model term: " + key );
+      }
+   }
+
+   return model;
+}
+
+void PointingModel::Apply( double& azimuth, double& elevation ) const
+{
+   Apply( std::sin( azimuth ), std::cos( azimuth ),
+          std::sin( elevation ), std::cos( elevation ),
+          azimuth, elevation );
+}
+
+void PointingModel::Apply( const double sin_az,
+                           const double cos_az,
+                           const double sin_el,
+                           const double cos_el,
+                           double& azimuth,
+                           double& elevation ) const
+{
+   /*
+    * the collimation term is unbounded at the zenith, where the azimuth is
+    * undefined anyway
+    */
+   const double tan_el = cos_el != 0.0 ? sin_el / cos_el : 0.0;
+
+   azimuth += Util::DegreesToRadians( az0
+                                      + an * sin_az
+                                      + ac * cos_az
+                                      + coll * tan_el );
+   elevation += Util::DegreesToRadians( el0
+                                        + grav * cos_el
+                                        + el_lin * sin_el );
+}
+
+std::string PointingModel::ToString() const
+{
+   std::stringstream ss;
+   ss.precision( 8 );
+   ss << "AZ0 " << az0 << "\n";
+   ss << "AN " << an << "\n";
+   ss << "AC " << ac << "\n";
+   ss << "COLL " << coll << "\n";
+   ss << "EL0 " << el0 << "\n";
+   ss << "GRAV " << grav << "\n";
+   ss << "EL_LIN " << el_lin << "\n";
+   return ss.str();
+}
+
+} // namespace libsgp4
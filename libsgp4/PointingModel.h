@@ -0,0 +1,138 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+namespace libsgp4
+{
+
+/**
+ * @brief One calibration point: the predicted look angle of a satellite and
+ * the encoder angles at which its signal peaked. Angles are in degrees.
+ */
+struct CalPoint
+{
+   /** predicted azimuth */
+   double platonic_az_deg;
+   /** predicted elevation */
+   double platonic_el_deg;
+   /** encoder azimuth at the signal peak */
+   double peak_az_deg;
+   /** encoder elevation at the signal peak */
+   double peak_el_deg;
+
+   /**
+    * @returns the azimuth residual the model has to match
+    */
+   double dAz() const
+   {
+      return peak_az_deg - platonic_az_deg;
+   }
+
+   /**
+    * @returns the elevation residual the model has to match
+    */
+   double dEl() const
+   {
+      return peak_el_deg - platonic_el_deg;
+   }
+};
+
+/**
+ * @brief The 7 term mount pointing model. Terms are in degrees.
+ *
+ * corrected az = az + AZ0 + AN sin(az) + AC cos(az) + COLL tan(el)
+ * corrected el = el + EL0 + GRAV cos(el) + EL_LIN sin(el)
+ *
+ * A model file holds one "KEY value" pair per line, using the term names
+ * above. Blank lines and lines starting with '#' are ignored, and terms not
+ * given are zero.
+ */
+struct PointingModel
+{
+   /** azimuth zero offset */
+   double az0{};
+   /** north-south axis tilt */
+   double an{};
+   /** east-west axis tilt */
+   double ac{};
+   /** collimation error */
+   double coll{};
+   /** elevation zero offset */
+   double el0{};
+   /** gravity sag */
+   double grav{};
+   /** elevation linearity */
+   double el_lin{};
+
+   /**
+    * Load a model from a file
+    * @param[in] filename the model file
+    * @returns the model
+    * @throws std::runtime_error if the file cannot be read or parsed
+    */
+   static PointingModel FromFile( const std::string& filename );
+
+   /**
+    * Load a model from a stream
+    * @param[in] stream the model
+    * @returns the model
+    * @throws std::runtime_error if the stream cannot be parsed
+    */
+   static PointingModel FromStream( std::istream& stream );
+
+   /**
+    * Apply the model to a look angle
+    * @param[in,out] azimuth azimuth in radians
+    * @param[in,out] elevation elevation in radians
+    */
+   void Apply( double& azimuth, double& elevation ) const;
+
+   /**
+    * Apply the model to a look angle whose sines and cosines are already
+    * known, without further trigonometry
+    * @param[in] sin_az sine of the azimuth
+    * @param[in] cos_az cosine of the azimuth
+    * @param[in] sin_el sine of the elevation
+    * @param[in] cos_el cosine of the elevation
+    * @param[in,out] azimuth azimuth in radians
+    * @param[in,out] elevation elevation in radians
+    */
+   void Apply( const double sin_az,
+               const double cos_az,
+               const double sin_el,
+               const double cos_el,
+               double& azimuth,
+               double& elevation ) const;
+
+   /**
+    * Convert this model to a string, in the model file format
+    * @returns this model as a string
+    */
+   std::string ToString() const;
+};
+
+inline std::ostream& operator<<( std::ostream& strm, const PointingModel& m )
+{
+   return strm << m.ToString();
+}
+
+} // namespace libsgp4
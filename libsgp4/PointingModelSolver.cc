@@ -0,0 +1,56 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "PointingModelSolver.h"
+
+#include "Util.h"
+
+#include <cmath>
+
+namespace libsgp4
+{
+
+void PointingModelSolver::Add( const CalPoint& point, const double weight )
+{
+   const double az = Util::DegreesToRadians( point.platonic_az_deg );
+   const double el = Util::DegreesToRadians( point.platonic_el_deg );
+
+   m_solver.Forget();
+   m_solver.Add( { 1.0, std::sin( az ), std::cos( az ), std::tan( el ),
+                   0.0, 0.0, 0.0 },
+                 point.dAz(), weight );
+   m_solver.Add( { 0.0, 0.0, 0.0, 0.0,
+                   1.0, std::cos( el ), std::sin( el ) },
+                 point.dEl(), weight );
+}
+
+PointingModel PointingModelSolver::Model() const
+{
+   const IncrementalLeastSquares<kParameters>::Row x = m_solver.Solve();
+
+   PointingModel model;
+   model.az0 = x[0];
+   model.an = x[1];
+   model.ac = x[2];
+   model.coll = x[3];
+   model.el0 = x[4];
+   model.grav = x[5];
+   model.el_lin = x[6];
+   return model;
+}
+
+} // namespace libsgp4
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "IncrementalLeastSquares.h"
+#include "PointingModel.h"
+
+#include <cstddef>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Fits the 7 term pointing model one calibration point at a time.
+ *
+ * Each point adds an azimuth and an elevation equation to an incremental QR
+ * factorisation, so the model is available after every point at O(p^2)
+ * cost, and matches a batch least squares fit over the same points.
+ * Parameters are ordered AZ0, AN, AC, COLL, EL0, GRAV, EL_LIN, in degrees.
+ */
+class PointingModelSolver
+{
+public:
+   /** number of model parameters */
+   static const size_t kParameters = 7;
+
+   using Covariance = IncrementalLeastSquares<kParameters>::Matrix;
+
+   /**
+    * Constructor
+    * @param[in] forgetting_factor weight kept by earlier points each time
+    * one is added, in (0, 1]; one weighs all points equally
+    */
+   explicit PointingModelSolver( const double forgetting_factor = 1.0 )
+      : m_solver( forgetting_factor )
+   {
+   }
+
+   /**
+    * Add a calibration point
+    * @param[in] point the calibration point
+    * @param[in] weight the weight of the point
+    */
+   void Add( const CalPoint& point, const double weight = 1.0 );
+
+   /**
+    * Solve for the model. Terms the points do not determine yet are zero.
+    * @returns the model
+    */
+   PointingModel Model() const;
+
+   /**
+    * Get the covariance of the model terms, in degrees squared
+    * @param[out] covariance the covariance
+    * @returns false until the points determine every term
+    */
+   bool GetCovariance( Covariance& covariance ) const
+   {
+      return m_solver.Covariance( covariance );
+   }
+
+   /**
+    * @returns the RMS residual of the fit in degrees
+    */
+   double RmsResidual() const
+   {
+      return m_solver.RmsResidual();
+   }
+
+   /**
+    * @returns the number of calibration points added
+    */
+   size_t Count() const
+   {
+      return m_solver.Count() / 2;
+   }
+
+   /**
+    * Discard all calibration points
+    */
+   void Reset()
+   {
+      m_solver.Reset();
+   }
+
+private:
+   IncrementalLeastSquares<kParameters> m_solver;
+};
+
+} // namespace libsgp4
@@ -0,0 +1,195 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "PropagationStatus.h"
+#include "Vector3.h"
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief An allocator for storage aligned beyond the default.
+ */
+template <typename T, size_t Alignment>
+struct AlignedAllocator
+{
+   typedef T value_type;
+
+   template <typename U>
+   struct rebind
+   {
+      typedef AlignedAllocator<U, Alignment> other;
+   };
+
+   AlignedAllocator() = default;
+
+   template <typename U>
+   AlignedAllocator( const AlignedAllocator<U, Alignment>& )
+   {
+   }
+
+   T* allocate( const size_t n )
+   {
+      return static_cast<T*>( ::operator new( n * sizeof( T ),
+                                              std::align_val_t( Alignment ) ) );
+   }
+
+   void deallocate( T* p, const size_t )
+   {
+      ::operator delete( p, std::align_val_t( Alignment ) );
+   }
+
+   template <typename U>
+   bool operator==( const AlignedAllocator<U, Alignment>& ) const
+   {
+      return true;
+   }
+
+   template <typename U>
+   bool operator!=( const AlignedAllocator<U, Alignment>& ) const
+   {
+      return false;
+   }
+};
+
+/**
+ * @brief Positions and velocities of a batch, stored as structure of arrays.
+ *
+ * Each component lives in its own 32 byte aligned array, so a loop over the
+ * batch reads and writes contiguous lanes. Positions are in km and
+ * velocities in km/s; each sample also has the status of its propagation.
+ */
+class PositionBuffer
+{
+public:
+   enum Component
+   {
+      X,
+      Y,
+      Z,
+      XDOT,
+      YDOT,
+      ZDOT,
+      COMPONENTS
+   };
+
+   static const size_t kAlignment = 32;
+
+   /**
+    * Resize every component
+    * @param[in] count the number of samples
+    */
+   void Resize( const size_t count )
+   {
+      for ( auto& data : m_data )
+      {
+         data.resize( count );
+      }
+      m_status.resize( count );
+   }
+
+   /**
+    * @returns the number of samples
+    */
+   size_t Size() const
+   {
+      return m_data[X].size();
+   }
+
+   /**
+    * @param[in] c the component
+    * @returns the array of the component
+    */
+   double* Data( const Component c )
+   {
+      return m_data[c].data();
+   }
+
+   /**
+    * @param[in] c the component
+    * @returns the array of the component
+    */
+   const double* Data( const Component c ) const
+   {
+      return m_data[c].data();
+   }
+
+   /**
+    * @returns the array of the statuses
+    */
+   PropagationStatus* Status()
+   {
+      return m_status.data();
+   }
+
+   /**
+    * @param[in] i the sample
+    * @returns the status of the sample
+    */
+   PropagationStatus Status( const size_t i ) const
+   {
+      return m_status[i];
+   }
+
+   /**
+    * @param[in] i the sample
+    * @returns the position of the sample
+    */
+   Vector3 Position( const size_t i ) const
+   {
+      return Vector3( m_data[X][i], m_data[Y][i], m_data[Z][i] );
+   }
+
+   /**
+    * @param[in] i the sample
+    * @returns the velocity of the sample
+    */
+   Vector3 Velocity( const size_t i ) const
+   {
+      return Vector3( m_data[XDOT][i], m_data[YDOT][i], m_data[ZDOT][i] );
+   }
+
+   /**
+    * Store a sample
+    * @param[in] i the sample
+    * @param[in] position the position
+    * @param[in] velocity the velocity
+    */
+   void Set( const size_t i, const Vector3& position, const Vector3& velocity )
+   {
+      m_data[X][i] = position.x;
+      m_data[Y][i] = position.y;
+      m_data[Z][i] = position.z;
+      m_data[XDOT][i] = velocity.x;
+      m_data[YDOT][i] = velocity.y;
+      m_data[ZDOT][i] = velocity.z;
+   }
+
+private:
+   /** one array per component */
+   std::vector<double, AlignedAllocator<double, kAlignment>> m_data[COMPONENTS];
+   /** the status of each sample */
+   std::vector<PropagationStatus> m_status;
+};
+
+} // namespace libsgp4
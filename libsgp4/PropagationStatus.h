@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+namespace libsgp4
+{
+
+/**
+ * @brief The outcome of propagating one sample.
+ */
+enum class PropagationStatus : uint8_t
+{
+   /** the state vector is valid */
+   OK,
+   /** the satellite is below the surface; the state vector is still given */
+   DECAYED,
+   /** the eccentricity fell to -0.001 or below */
+   ECCENTRICITY_OUT_OF_RANGE,
+   /** elsq reached 1 in the long period periodics */
+   ELSQ_OUT_OF_RANGE,
+   /** the semi-latus rectum went negative */
+   SEMI_LATUS_RECTUM_NEGATIVE,
+   /** the deep space mean motion fell to zero or below */
+   MEAN_MOTION_OUT_OF_RANGE
+};
+
+/**
+ * @param[in] status the status
+ * @returns the message the exception API reports for the status
+ */
+inline const char* ToString( const PropagationStatus status ) noexcept
+{
+   switch ( status )
+   {
+   case PropagationStatus::OK:
+      return "OK";
+   case PropagationStatus::DECAYED:
+      return "Satellite decayed";
+   case PropagationStatus::ECCENTRICITY_OUT_OF_RANGE:
+      return "Error: (e <= -0.001)";
+   case PropagationStatus::ELSQ_OUT_OF_RANGE:
+      return "Error: (elsq >= 1.0)";
+   case PropagationStatus::SEMI_LATUS_RECTUM_NEGATIVE:
+      return "Error: (pl < 0.0)";
+   case PropagationStatus::MEAN_MOTION_OUT_OF_RANGE:
+      return "Error: (xn <= 0.0)";
+   }
+   return "Unknown status";
+}
+
+} // namespace libsgp4
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "PropagatorCache.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * file layout: magic and the number of states, then per state its
+ * fingerprint, its size and the state itself, all little endian
+ */
+const char kCacheMagic[4] = { 'S', 'G', 'P', 'C' };
+
+/*
+ * states are a few kilobytes; anything larger is a corrupt file
+ */
+const uint32_t kMaximumStateSize = 1 << 16;
+
+void PutLittleEndian( std::ostream& os, const uint64_t value, const size_t size )
+{
+   char bytes[8];
+   for ( size_t i = 0; i < size; i++ )
+   {
+      bytes[i] = static_cast<char>( ( value >> ( 8 * i ) ) & 0xff );
+   }
+   os.write( bytes, static_cast<std::streamsize>( size ) );
+}
+
+bool GetLittleEndian( std::istream& is, uint64_t& value, const size_t size )
+{
+   char bytes[8];
+   if ( !is.read( bytes, static_cast<std::streamsize>( size ) ) )
+   {
+      return false;
+   }
+   value = 0;
+   for ( size_t i = 0; i < size; i++ )
+   {
+      value |= static_cast<uint64_t>( static_cast<unsigned char>( bytes[i] ) ) << ( 8 * i );
+   }
+   return true;
+}
+} // namespace
+
+SGP4 PropagatorCache::Get( const Tle& tle )
+{
+   /*
+    * a state of another tle with the same fingerprint, or from another
+    * build, is a miss and is replaced
+    */
+   const auto itr = m_states.find( SGP4::Fingerprint( tle ) );
+   if ( itr != m_states.end() && SGP4::IsStateOf( tle, itr->second ) )
+   {
+      SGP4 sgp4( tle, itr->second );
+      m_hits++;
+      return sgp4;
+   }
+
+   SGP4 sgp4( tle );
+   m_misses++;
+   Add( sgp4 );
+   return sgp4;
+}
+
+void PropagatorCache::Add( const SGP4& sgp4 )
+{
+   m_states[sgp4.GetFingerprint()] = sgp4.SaveState();
+}
+
+bool PropagatorCache::Save( std::ostream& os ) const
+{
+   os.write( kCacheMagic, sizeof( kCacheMagic ) );
+   PutLittleEndian( os, m_states.size(), 4 );
+   for ( const auto& entry : m_states )
+   {
+      PutLittleEndian( os, entry.first, 8 );
+      PutLittleEndian( os, entry.second.size(), 4 );
+      os.write( entry.second.data(), static_cast<std::streamsize>( entry.second.size() ) );
+   }
+   return static_cast<bool>( os );
+}
+
+bool PropagatorCache::Save( const std::string& filename ) const
+{
+   std::ofstream os( filename, std::ios::binary );
+   return os.is_open() && Save( os );
+}
+
+bool PropagatorCache::Load( std::istream& is )
+{
+   char magic[sizeof( kCacheMagic )];
+   uint64_t count;
+   if ( !is.read( magic, sizeof( magic ) )
+         || std::memcmp( magic, kCacheMagic, sizeof( magic ) ) != 0
+         || !GetLittleEndian( is, count, 4 ) )
+   {
+      return false;
+   }
+
+   for ( uint64_t i = 0; i < count; i++ )
+   {
+      uint64_t fingerprint;
+      uint64_t size;
+      if ( !GetLittleEndian( is, fingerprint, 8 )
+            || !GetLittleEndian( is, size, 4 )
+            || size > kMaximumStateSize )
+      {
+         return false;
+      }
+
+      std::vector<char> state( size );
+      if ( !is.read( state.data(), static_cast<std::streamsize>( size ) ) )
+      {
+         return false;
+      }
+      m_states[fingerprint] = std::move( state );
+   }
+
+   return true;
+}
+
+bool PropagatorCache::Load( const std::string& filename )
+{
+   std::ifstream is( filename, std::ios::binary );
+   return is.is_open() && Load( is );
+}
+
+} // namespace libsgp4
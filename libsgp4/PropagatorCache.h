@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "SGP4.h"
+#include "Tle.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Saved propagator states, keyed by SGP4::Fingerprint.
+ *
+ * Saving the cache when a service stops and loading it when the service
+ * starts again turns rebuilding every propagator into restoring its saved
+ * state, skipping the initialisation. The file holds states of this build
+ * of the library only; SGP4 rejects any other and initialises instead.
+ *
+ * Not thread safe.
+ */
+class PropagatorCache
+{
+public:
+   /**
+    * Get a propagator, restored from the cache when it holds the state of
+    * the tle, otherwise initialised and its state added to the cache
+    * @param[in] tle the element set
+    * @returns the propagator
+    * @exception SatelliteException if the elements are invalid
+    */
+   SGP4 Get( const Tle& tle );
+
+   /**
+    * Add or replace the state of a propagator
+    * @param[in] sgp4 the propagator
+    */
+   void Add( const SGP4& sgp4 );
+
+   /**
+    * @returns the number of states held
+    */
+   size_t Size() const
+   {
+      return m_states.size();
+   }
+
+   /**
+    * @returns the number of Get calls that restored a state
+    */
+   uint64_t Hits() const
+   {
+      return m_hits;
+   }
+
+   /**
+    * @returns the number of Get calls that had to initialise
+    */
+   uint64_t Misses() const
+   {
+      return m_misses;
+   }
+
+   /**
+    * Discard all the states
+    */
+   void Clear()
+   {
+      m_states.clear();
+   }
+
+   /**
+    * Write the states
+    * @param[in] os the stream to write to
+    * @returns whether the states were written
+    */
+   bool Save( std::ostream& os ) const;
+
+   /**
+    * Write the states to a file
+    * @param[in] filename the file to write
+    * @returns whether the states were written
+    */
+   bool Save( const std::string& filename ) const;
+
+   /**
+    * Add the states written by Save
+    * @param[in] is the stream to read from
+    * @returns false if the stream is not a cache or is truncated; the states
+    * read before the problem are kept
+    */
+   bool Load( std::istream& is );
+
+   /**
+    * Add the states written by Save to a file
+    * @param[in] filename the file to read
+    * @returns false if the file cannot be read or is not a cache
+    */
+   bool Load( const std::string& filename );
+
+private:
+   /** the saved states by fingerprint */
+   std::unordered_map<uint64_t, std::vector<char>> m_states;
+   /** Get calls that restored a state */
+   uint64_t m_hits{};
+   /** Get calls that initialised */
+   uint64_t m_misses{};
+};
+
+} // namespace libsgp4
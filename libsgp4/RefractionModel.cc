@@ -0,0 +1,105 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "RefractionModel.h"
+
+#include "Globals.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * offset in arc minutes that makes Saemundsson's formula zero at the zenith
+ */
+const double kZenithOffset = 0.0019279;
+
+/*
+ * the formula is for 1010 hPa and 10 degrees Celsius
+ */
+const double kStandardPressure = 1010.0;
+const double kStandardTemperature = 283.15;
+const double kCelsiusToKelvin = 273.15;
+
+/*
+ * water vapour pressure in hPa over water (ITU-R P.453)
+ */
+double VapourPressure( const double temperature, const double relative_humidity )
+{
+   return relative_humidity / 100.0 * 6.1121
+          * std::exp( 17.502 * temperature / ( temperature + 240.97 ) );
+}
+}
+
+RefractionModel::RefractionModel( const SurfaceConditions& conditions,
+                                  const RefractionBand band,
+                                  const double step )
+   : m_conditions( conditions )
+   , m_band( band )
+{
+   const double temperature = conditions.temperature + kCelsiusToKelvin;
+   if ( step <= 0.0 || conditions.pressure < 0.0 || temperature <= 0.0 )
+   {
+      throw std::invalid_argument( "Invalid refraction table step or surface conditions" );
+   }
+
+   m_scale = conditions.pressure / kStandardPressure
+             * kStandardTemperature / temperature;
+
+   /*
+    * radio refractivity is 77.6 / T (P + 4810 e / T), of which the dry part
+    * 77.6 P / T is what the optical formula accounts for
+    */
+   if ( band == RefractionBand::RADIO && conditions.pressure > 0.0 )
+   {
+      const double e = VapourPressure( conditions.temperature,
+                                       conditions.relative_humidity );
+      m_scale *= 1.0 + 4810.0 * e / ( temperature * conditions.pressure );
+   }
+
+   const size_t count = static_cast<size_t>(
+                           std::ceil( ( kPI / 2.0 - kMinimumElevation ) / step ) ) + 1;
+   m_table.resize( count );
+   for ( size_t i = 0; i < count; i++ )
+   {
+      m_table[i] = Evaluate( kMinimumElevation + static_cast<double>( i ) * step );
+   }
+   m_inverse_step = 1.0 / step;
+   m_last = static_cast<double>( count - 1 );
+}
+
+double RefractionModel::Evaluate( const double elevation ) const
+{
+   /*
+    * Saemundsson, with the elevation in degrees and the refraction in arc
+    * minutes
+    */
+   const double h = std::min( std::max( Util::RadiansToDegrees( elevation ),
+                                        Util::RadiansToDegrees( kMinimumElevation ) ),
+                              90.0 );
+   const double r = 1.02 / std::tan( Util::DegreesToRadians( h + 10.3 / ( h + 5.11 ) ) )
+                    + kZenithOffset;
+   return Util::DegreesToRadians( std::max( r, 0.0 ) / 60.0 ) * m_scale;
+}
+
+} // namespace libsgp4
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief The wavelengths a refraction model is for.
+ */
+enum class RefractionBand
+{
+   /** visible light, dry air only */
+   OPTICAL,
+   /** radio frequencies, where water vapour adds to the refractivity */
+   RADIO
+};
+
+/**
+ * @brief Surface conditions at the observer.
+ */
+struct SurfaceConditions
+{
+   /** pressure in hPa */
+   double pressure{ 1010.0 };
+   /** temperature in degrees Celsius */
+   double temperature{ 10.0 };
+   /** relative humidity in percent, used by the radio band only */
+   double relative_humidity{ 50.0 };
+};
+
+/**
+ * @brief Atmospheric refraction, the amount the apparent elevation of an
+ * object exceeds its geometric elevation.
+ *
+ * The refraction follows Saemundsson's formula for the geometric elevation,
+ * scaled for the surface pressure and temperature. For the radio band it is
+ * scaled again by the ratio of the radio to the dry surface refractivity,
+ * which adds the contribution of water vapour.
+ *
+ * The formula is tabulated once at construction, so a lookup is a linear
+ * interpolation between two entries. Elevations below the table clamp to
+ * its first entry and the refraction is zero at the zenith.
+ */
+class RefractionModel
+{
+public:
+   /**
+    * Constructor
+    * @param[in] conditions the surface conditions
+    * @param[in] band the wavelengths the model is for
+    * @param[in] step table spacing in radians
+    */
+   explicit RefractionModel( const SurfaceConditions& conditions = SurfaceConditions(),
+                             const RefractionBand band = RefractionBand::RADIO,
+                             const double step = 1.74532925199432958e-4 );
+
+   /**
+    * @param[in] elevation geometric elevation in radians
+    * @returns the refraction in radians, from the table
+    */
+   double Refraction( const double elevation ) const
+   {
+      double x = ( elevation - kMinimumElevation ) * m_inverse_step;
+      if ( x <= 0.0 )
+      {
+         return m_table.front();
+      }
+      if ( x >= m_last )
+      {
+         return m_table.back();
+      }
+      const size_t i = static_cast<size_t>( x );
+      x -= static_cast<double>( i );
+      return m_table[i] + x * ( m_table[i + 1] - m_table[i] );
+   }
+
+   /**
+    * @param[in] elevation geometric elevation in radians
+    * @returns the apparent elevation in radians
+    */
+   double Apparent( const double elevation ) const
+   {
+      return elevation + Refraction( elevation );
+   }
+
+   /**
+    * @param[in] elevation geometric elevation in radians
+    * @returns the refraction in radians, evaluated directly from the formula
+    */
+   double Evaluate( const double elevation ) const;
+
+   /**
+    * @returns the surface conditions
+    */
+   const SurfaceConditions& Conditions() const
+   {
+      return m_conditions;
+   }
+
+   /**
+    * @returns the wavelengths the model is for
+    */
+   RefractionBand Band() const
+   {
+      return m_band;
+   }
+
+   /** lowest tabulated geometric elevation in radians, -2 degrees */
+   static constexpr double kMinimumElevation = -3.49065850398865915e-2;
+
+private:
+   /** the surface conditions */
+   SurfaceConditions m_conditions;
+   /** the wavelengths the model is for */
+   RefractionBand m_band;
+   /** scale applied to the standard Saemundsson refraction */
+   double m_scale{};
+   /** inverse of the table spacing */
+   double m_inverse_step{};
+   /** table position of the last entry */
+   double m_last{};
+   /** refraction in radians from kMinimumElevation to the zenith */
+   std::vector<double> m_table;
+};
+
+} // namespace libsgp4
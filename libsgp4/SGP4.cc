@@ -21,7 +21,10 @@
 #include "Vector.h"
 #include "SatelliteException.h"
 #include "DecayedException.h"
+#include "Instrumentation.h"
+#include "Tracing.h"
 
+#include <array>
 #include <cmath>
 #include <iomanip>
 #include <cstring>
@@ -29,6 +32,88 @@
 namespace libsgp4
 {
 
+namespace
+{
+/*
+ * saved state layout: magic, version, the sizes of the constant structures
+ * so a state from a different build is rejected, the elements the state
+ * is of so they are compared exactly, the flags, then the structures as
+ * they are in memory
+ */
+const char kStateMagic[4] = { 'S', 'G', 'P', '4' };
+const uint32_t kStateVersion = 2;
+
+/*
+ * the elements read from the tle, the epoch in ticks; the others are
+ * derived from these
+ */
+const size_t kElementsSize = 7 * sizeof( double ) + sizeof( int64_t );
+const size_t kStateHeaderSize = 4 + 4 * 4 + kElementsSize + 4;
+
+template <typename T>
+void PutRaw( std::vector<char>& out, const T& value )
+{
+   const char* p = reinterpret_cast<const char*>( &value );
+   out.insert( out.end(), p, p + sizeof( T ) );
+}
+
+template <typename T>
+T GetRaw( const char*& p )
+{
+   T value;
+   std::memcpy( &value, p, sizeof( T ) );
+   p += sizeof( T );
+   return value;
+}
+
+std::array<char, kElementsSize> ElementBytes( const OrbitalElements& elements )
+{
+   const double values[7] = {
+      elements.MeanAnomoly(),
+      elements.AscendingNode(),
+      elements.ArgumentPerigee(),
+      elements.Eccentricity(),
+      elements.Inclination(),
+      elements.MeanMotion(),
+      elements.BStar()
+   };
+   const int64_t epoch = elements.Epoch().Ticks();
+
+   std::array<char, kElementsSize> bytes;
+   std::memcpy( bytes.data(), values, sizeof( values ) );
+   std::memcpy( bytes.data() + sizeof( values ), &epoch, sizeof( epoch ) );
+   return bytes;
+}
+
+/*
+ * FNV-1a
+ */
+uint64_t Hash( const std::array<char, kElementsSize>& bytes )
+{
+   uint64_t hash = 14695981039346656037ULL;
+   for ( const char c : bytes )
+   {
+      hash ^= static_cast<unsigned char>( c );
+      hash *= 1099511628211ULL;
+   }
+   return hash;
+}
+} // namespace
+
+SGP4::SGP4( const Tle& tle, const std::vector<char>& state )
+   : elements_( tle )
+{
+   const char* constants = CheckState( state, elements_ );
+   if ( constants != nullptr )
+   {
+      LoadState( constants );
+   }
+   else
+   {
+      Initialise();
+   }
+}
+
 void SGP4::SetTle( const Tle& tle )
 {
    /*
@@ -39,8 +124,101 @@ void SGP4::SetTle( const Tle& tle )
    Initialise();
 }
 
+uint64_t SGP4::Fingerprint( const Tle& tle )
+{
+   return Hash( ElementBytes( OrbitalElements( tle ) ) );
+}
+
+uint64_t SGP4::GetFingerprint() const
+{
+   return Hash( ElementBytes( elements_ ) );
+}
+
+std::vector<char> SGP4::SaveState() const
+{
+   std::vector<char> state;
+   state.reserve( kStateHeaderSize + sizeof( common_consts_ )
+                  + sizeof( nearspace_consts_ ) + sizeof( deepspace_consts_ ) );
+
+   state.insert( state.end(), kStateMagic, kStateMagic + sizeof( kStateMagic ) );
+   PutRaw( state, kStateVersion );
+   PutRaw( state, static_cast<uint32_t>( sizeof( common_consts_ ) ) );
+   PutRaw( state, static_cast<uint32_t>( sizeof( nearspace_consts_ ) ) );
+   PutRaw( state, static_cast<uint32_t>( sizeof( deepspace_consts_ ) ) );
+   PutRaw( state, ElementBytes( elements_ ) );
+   const uint32_t flags = ( use_simple_model_ ? 1U : 0U ) | ( use_deep_space_ ? 2U : 0U );
+   PutRaw( state, flags );
+
+   PutRaw( state, common_consts_ );
+   PutRaw( state, nearspace_consts_ );
+   PutRaw( state, deepspace_consts_ );
+   return state;
+}
+
+bool SGP4::RestoreState( const Tle& tle, const std::vector<char>& state )
+{
+   const OrbitalElements elements( tle );
+   const char* constants = CheckState( state, elements );
+   if ( constants == nullptr )
+   {
+      return false;
+   }
+
+   elements_ = elements;
+   LoadState( constants );
+   return true;
+}
+
+bool SGP4::IsStateOf( const Tle& tle, const std::vector<char>& state )
+{
+   return CheckState( state, OrbitalElements( tle ) ) != nullptr;
+}
+
+const char* SGP4::CheckState( const std::vector<char>& state,
+                              const OrbitalElements& elements )
+{
+   const size_t size = kStateHeaderSize + sizeof( common_consts_ )
+                       + sizeof( nearspace_consts_ ) + sizeof( deepspace_consts_ );
+   if ( state.size() != size
+         || std::memcmp( state.data(), kStateMagic, sizeof( kStateMagic ) ) != 0 )
+   {
+      return nullptr;
+   }
+
+   const char* p = state.data() + sizeof( kStateMagic );
+   if ( GetRaw<uint32_t>( p ) != kStateVersion
+         || GetRaw<uint32_t>( p ) != sizeof( common_consts_ )
+         || GetRaw<uint32_t>( p ) != sizeof( nearspace_consts_ )
+         || GetRaw<uint32_t>( p ) != sizeof( deepspace_consts_ ) )
+   {
+      return nullptr;
+   }
+
+   const std::array<char, kElementsSize> bytes = ElementBytes( elements );
+   if ( std::memcmp( p, bytes.data(), bytes.size() ) != 0 )
+   {
+      return nullptr;
+   }
+   return p + bytes.size();
+}
+
+void SGP4::LoadState( const char* p )
+{
+   SGP4_TRACE_SCOPE( "SGP4::LoadState" );
+
+   const uint32_t flags = GetRaw<uint32_t>( p );
+   use_simple_model_ = ( flags & 1U ) != 0;
+   use_deep_space_ = ( flags & 2U ) != 0;
+   common_consts_ = GetRaw<CommonConstants>( p );
+   nearspace_consts_ = GetRaw<NearSpaceConstants>( p );
+   deepspace_consts_ = GetRaw<DeepSpaceConstants>( p );
+   ResetIntegrator();
+}
+
 void SGP4::Initialise()
 {
+   SGP4_TRACE_SCOPE( "SGP4::Initialise" );
+
    /*
     * reset all constants etc
     */
@@ -210,25 +388,96 @@ void SGP4::Initialise()
       }
    }
 }
+namespace
+{
+template <typename T>
+PropagationStatus FinalPositionVelocity(
+   const T e,
+   const T a,
+   const T omega,
+   const T xl,
+   const T xnode,
+   const T xinc,
+   const T xlcof,
+   const T aycof,
+   const T x3thm1,
+   const T x1mth2,
+   const T x7thm1,
+   const T cosio,
+   const T sinio,
+   T position[3],
+   T velocity[3] ) noexcept;
+} // namespace
 
 Eci SGP4::FindPosition( const DateTime& dt ) const
 {
    return FindPosition( ( dt - elements_.Epoch() ).TotalMinutes() );
 }
-
 Eci SGP4::FindPosition( double tsince ) const
 {
+   Vector3 position;
+   Vector3 velocity;
+   const PropagationStatus status = Propagate( tsince, position, velocity );
+   if ( status == PropagationStatus::OK )
+   {
+      return Eci( elements_.Epoch().AddMinutes( tsince ),
+                  position.ToVector(),
+                  velocity.ToVector() );
+   }
+   if ( status == PropagationStatus::DECAYED )
+   {
+      throw DecayedException( elements_.Epoch().AddMinutes( tsince ),
+                              position.ToVector(),
+                              velocity.ToVector() );
+   }
+   throw SatelliteException( ToString( status ) );
+}
+
+PropagationStatus SGP4::Propagate( double tsince,
+                                   Vector3& position,
+                                   Vector3& velocity ) const noexcept
+{
+   double p[3];
+   double v[3];
+   PropagationStatus status;
    if ( use_deep_space_ )
    {
-      return FindPositionSDP4( tsince );
+      SGP4_COUNT( deep_space_calls );
+      status = PropagateSDP4( tsince, p, v );
    }
    else
    {
-      return FindPositionSGP4( tsince );
+      SGP4_COUNT( near_earth_calls );
+      SGP4_INSTRUMENT( if ( use_simple_model_ ) SGP4_COUNT( simple_calls ); )
+      status = PropagateSGP4( tsince, p, v );
    }
+
+   if ( status == PropagationStatus::OK || status == PropagationStatus::DECAYED )
+   {
+      position = Vector3( p[0], p[1], p[2] );
+      velocity = Vector3( v[0], v[1], v[2] );
+   }
+   return status;
+}
+
+PropagationStatus SGP4::Propagate( const DateTime& date, Eci& eci ) const noexcept
+{
+   const double tsince = ( date - elements_.Epoch() ).TotalMinutes();
+   Vector3 position;
+   Vector3 velocity;
+   const PropagationStatus status = Propagate( tsince, position, velocity );
+   if ( status == PropagationStatus::OK || status == PropagationStatus::DECAYED )
+   {
+      eci = Eci( elements_.Epoch().AddMinutes( tsince ),
+                 position.ToVector(),
+                 velocity.ToVector() );
+   }
+   return status;
 }
 
-Eci SGP4::FindPositionSDP4( double tsince ) const
+PropagationStatus SGP4::PropagateSDP4( const double tsince,
+                                      double position[3],
+                                      double velocity[3] ) const noexcept
 {
    /*
     * the final values
@@ -274,7 +523,7 @@ Eci SGP4::FindPositionSDP4( double tsince ) const
 
    if ( xn <= 0.0 )
    {
-      throw SatelliteException( "Error: (xn <= 0.0)" );
+      return PropagationStatus::MEAN_MOTION_OUT_OF_RANGE;
    }
 
    a = pow( kXKE / xn, kTWOTHIRD ) * tempa * tempa;
@@ -308,7 +557,7 @@ Eci SGP4::FindPositionSDP4( double tsince ) const
     */
    if ( e <= -0.001 )
    {
-      throw SatelliteException( "Error: (e <= -0.001)" );
+      return PropagationStatus::ECCENTRICITY_OUT_OF_RANGE;
    }
    else if ( e < 1.0e-6 )
    {
@@ -341,20 +590,21 @@ Eci SGP4::FindPositionSDP4( double tsince ) const
    /*
     * using calculated values, find position and velocity
     */
-   return CalculateFinalPositionVelocity( elements_.Epoch().AddMinutes( tsince ),
-                                          e,
-                                          a,
-                                          omega,
-                                          xl,
-                                          xnode,
-                                          xinc,
-                                          perturbed_xlcof,
-                                          perturbed_aycof,
-                                          perturbed_x3thm1,
-                                          perturbed_x1mth2,
-                                          perturbed_x7thm1,
-                                          perturbed_cosio,
-                                          perturbed_sinio );
+   return FinalPositionVelocity( e,
+                                 a,
+                                 omega,
+                                 xl,
+                                 xnode,
+                                 xinc,
+                                 perturbed_xlcof,
+                                 perturbed_aycof,
+                                 perturbed_x3thm1,
+                                 perturbed_x1mth2,
+                                 perturbed_x7thm1,
+                                 perturbed_cosio,
+                                 perturbed_sinio,
+                                 position,
+                                 velocity );
 }
 
 void SGP4::RecomputeConstants( const double xinc,
@@ -386,19 +636,13 @@ void SGP4::RecomputeConstants( const double xinc,
 
    aycof = 0.25 * kA3OVK2 * sinio;
 }
-
-Eci SGP4::FindPositionSGP4( double tsince ) const
+PropagationStatus SGP4::NearEarthSecular( const double tsince,
+      double& e,
+      double& a,
+      double& omega,
+      double& xl,
+      double& xnode ) const noexcept
 {
-   /*
-    * the final values
-    */
-   double e;
-   double a;
-   double omega;
-   double xl;
-   double xnode;
-   const double xinc = elements_.Inclination();
-
    /*
     * update for secular gravity and atmospheric drag
     */
@@ -449,7 +693,7 @@ Eci SGP4::FindPositionSGP4( double tsince ) const
     */
    if ( e <= -0.001 )
    {
-      throw SatelliteException( "Error: (e <= -0.001)" );
+      return PropagationStatus::ECCENTRICITY_OUT_OF_RANGE;
    }
    else if ( e < 1.0e-6 )
    {
@@ -460,58 +704,112 @@ Eci SGP4::FindPositionSGP4( double tsince ) const
       e = 1.0 - 1.0e-6;
    }
 
+   return PropagationStatus::OK;
+}
+
+PropagationStatus SGP4::PropagateSGP4( const double tsince,
+                                      double position[3],
+                                      double velocity[3] ) const noexcept
+{
+   /*
+    * the final values
+    */
+   double e;
+   double a;
+   double omega;
+   double xl;
+   double xnode;
+   const double xinc = elements_.Inclination();
+
+   const PropagationStatus status = NearEarthSecular( tsince, e, a, omega, xl, xnode );
+   if ( status != PropagationStatus::OK )
+   {
+      return status;
+   }
+
    /*
     * using calculated values, find position and velocity
     * we can pass in constants from Initialise() as these dont change
     */
-   return CalculateFinalPositionVelocity( elements_.Epoch().AddMinutes( tsince ),
-                                          e,
-                                          a,
-                                          omega,
-                                          xl,
-                                          xnode,
-                                          xinc,
-                                          common_consts_.xlcof,
-                                          common_consts_.aycof,
-                                          common_consts_.x3thm1,
-                                          common_consts_.x1mth2,
-                                          common_consts_.x7thm1,
-                                          common_consts_.cosio,
-                                          common_consts_.sinio );
+   return FinalPositionVelocity( e,
+                                 a,
+                                 omega,
+                                 xl,
+                                 xnode,
+                                 xinc,
+                                 common_consts_.xlcof,
+                                 common_consts_.aycof,
+                                 common_consts_.x3thm1,
+                                 common_consts_.x1mth2,
+                                 common_consts_.x7thm1,
+                                 common_consts_.cosio,
+                                 common_consts_.sinio,
+                                 position,
+                                 velocity );
 }
 
-Eci SGP4::CalculateFinalPositionVelocity(
-   const DateTime& dt,
-   const double e,
-   const double a,
-   const double omega,
-   const double xl,
-   const double xnode,
-   const double xinc,
-   const double xlcof,
-   const double aycof,
-   const double x3thm1,
-   const double x1mth2,
-   const double x7thm1,
-   const double cosio,
-   const double sinio )
+namespace
+{
+/*
+ * convergence tolerance of the Kepler solution, near the rounding error of
+ * each precision
+ */
+template <typename T>
+T KeplerTolerance();
+
+template <>
+double KeplerTolerance<double>()
 {
-   const double beta2 = 1.0 - e * e;
-   const double xn = kXKE / pow( a, 1.5 );
+   return 1.0e-12;
+}
+
+template <>
+float KeplerTolerance<float>()
+{
+   return 1.0e-6f;
+}
+
+/*
+ * The final stage of the model, shared by both precisions: the long and
+ * short period periodics, Keplers equation and the orientation. Every
+ * constant is cast to T, so the double instantiation performs exactly the
+ * original arithmetic. The state vector is filled when the status is OK or
+ * DECAYED.
+ */
+template <typename T>
+PropagationStatus FinalPositionVelocity(
+   const T e,
+   const T a,
+   const T omega,
+   const T xl,
+   const T xnode,
+   const T xinc,
+   const T xlcof,
+   const T aycof,
+   const T x3thm1,
+   const T x1mth2,
+   const T x7thm1,
+   const T cosio,
+   const T sinio,
+   T position[3],
+   T velocity[3] ) noexcept
+{
+   const T beta2 = T( 1.0 ) - e * e;
+   const T xn = T( kXKE ) / std::pow( a, T( 1.5 ) );
    /*
     * long period periodics
     */
-   const double axn = e * cos( omega );
-   const double temp11 = 1.0 / ( a * beta2 );
-   const double xll = temp11 * xlcof * axn;
-   const double aynl = temp11 * aycof;
-   const double xlt = xl + xll;
-   const double ayn = e * sin( omega ) + aynl;
-   const double elsq = axn * axn + ayn * ayn;
-
-   if ( elsq >= 1.0 )
+   const T axn = e * std::cos( omega );
+   const T temp11 = T( 1.0 ) / ( a * beta2 );
+   const T xll = temp11 * xlcof * axn;
+   const T aynl = temp11 * aycof;
+   const T xlt = xl + xll;
+   const T ayn = e * std::sin( omega ) + aynl;
+   const T elsq = axn * axn + ayn * ayn;
+
+   if ( elsq >= T( 1.0 ) )
    {
-      throw SatelliteException( "Error: (elsq >= 1.0)" );
+      return PropagationStatus::ELSQ_OUT_OF_RANGE;
    }
 
    /*
@@ -522,41 +820,42 @@ Eci SGP4::CalculateFinalPositionVelocity(
     * - The fmod saves reduction of angle to +/-2pi in sin/cos() and prevents
     * convergence problems.
     */
-   const double capu = fmod( xlt - xnode, kTWOPI );
-   double epw = capu;
+   const T capu = std::fmod( xlt - xnode, T( kTWOPI ) );
+   T epw = capu;
 
-   double sinepw = 0.0;
-   double cosepw = 0.0;
-   double ecose = 0.0;
-   double esine = 0.0;
+   T sinepw = T( 0.0 );
+   T cosepw = T( 0.0 );
+   T ecose = T( 0.0 );
+   T esine = T( 0.0 );
 
    /*
     * sensibility check for N-R correction
     */
-   const double max_newton_naphson = 1.25 * fabs( sqrt( elsq ) );
+   const T max_newton_naphson = T( 1.25 ) * std::fabs( std::sqrt( elsq ) );
 
    bool kepler_running = true;
 
    for ( int i = 0; i < 10 && kepler_running; i++ )
    {
-      sinepw = sin( epw );
-      cosepw = cos( epw );
+      sinepw = std::sin( epw );
+      cosepw = std::cos( epw );
       ecose = axn * cosepw + ayn * sinepw;
       esine = axn * sinepw - ayn * cosepw;
 
-      double f = capu - epw + esine;
+      T f = capu - epw + esine;
 
-      if ( fabs( f ) < 1.0e-12 )
+      if ( std::fabs( f ) < KeplerTolerance<T>() )
       {
          kepler_running = false;
+         SGP4_HISTOGRAM( kepler_iterations, static_cast<size_t>( i + 1 ) );
       }
       else
       {
          /*
           * 1st order Newton-Raphson correction
           */
-         const double fdot = 1.0 - ecose;
-         double delta_epw = f / fdot;
+         const T fdot = T( 1.0 ) - ecose;
+         T delta_epw = f / fdot;
 
          /*
           * 2nd order Newton-Raphson correction.
@@ -575,7 +874,7 @@ Eci SGP4::CalculateFinalPositionVelocity(
          }
          else
          {
-            delta_epw = f / ( fdot + 0.5 * esine * delta_epw );
+            delta_epw = f / ( fdot + T( 0.5 ) * esine * delta_epw );
          }
 
          /*
@@ -584,83 +883,205 @@ Eci SGP4::CalculateFinalPositionVelocity(
          epw += delta_epw;
       }
    }
+   SGP4_INSTRUMENT(
+      if ( kepler_running )
+      {
+         /*
+          * past the iteration limit, apart from a solution that converged
+          * on the last iteration
+          */
+         SGP4_COUNT( kepler_unconverged );
+         SGP4_HISTOGRAM( kepler_iterations, 11 );
+      } )
    /*
     * short period preliminary quantities
     */
-   const double temp21 = 1.0 - elsq;
-   const double pl = a * temp21;
+   const T temp21 = T( 1.0 ) - elsq;
+   const T pl = a * temp21;
 
-   if ( pl < 0.0 )
+   if ( pl < T( 0.0 ) )
    {
-      throw SatelliteException( "Error: (pl < 0.0)" );
+      return PropagationStatus::SEMI_LATUS_RECTUM_NEGATIVE;
    }
 
-   const double r = a * ( 1.0 - ecose );
-   const double temp31 = 1.0 / r;
-   const double rdot = kXKE * sqrt( a ) * esine * temp31;
-   const double rfdot = kXKE * sqrt( pl ) * temp31;
-   const double temp32 = a * temp31;
-   const double betal = sqrt( temp21 );
-   const double temp33 = 1.0 / ( 1.0 + betal );
-   const double cosu = temp32 * ( cosepw - axn + ayn * esine * temp33 );
-   const double sinu = temp32 * ( sinepw - ayn - axn * esine * temp33 );
-   const double u = atan2( sinu, cosu );
-   const double sin2u = 2.0 * sinu * cosu;
-   const double cos2u = 2.0 * cosu * cosu - 1.0;
+   const T r = a * ( T( 1.0 ) - ecose );
+   const T temp31 = T( 1.0 ) / r;
+   const T rdot = T( kXKE ) * std::sqrt( a ) * esine * temp31;
+   const T rfdot = T( kXKE ) * std::sqrt( pl ) * temp31;
+   const T temp32 = a * temp31;
+   const T betal = std::sqrt( temp21 );
+   const T temp33 = T( 1.0 ) / ( T( 1.0 ) + betal );
+   const T cosu = temp32 * ( cosepw - axn + ayn * esine * temp33 );
+   const T sinu = temp32 * ( sinepw - ayn - axn * esine * temp33 );
+   const T u = std::atan2( sinu, cosu );
+   const T sin2u = T( 2.0 ) * sinu * cosu;
+   const T cos2u = T( 2.0 ) * cosu * cosu - T( 1.0 );
 
    /*
     * update for short periodics
     */
-   const double temp41 = 1.0 / pl;
-   const double temp42 = kCK2 * temp41;
-   const double temp43 = temp42 * temp41;
-
-   const double rk = r * ( 1.0 - 1.5 * temp43 * betal * x3thm1 )
-                     + 0.5 * temp42 * x1mth2 * cos2u;
-   const double uk = u - 0.25 * temp43 * x7thm1 * sin2u;
-   const double xnodek = xnode + 1.5 * temp43 * cosio * sin2u;
-   const double xinck = xinc + 1.5 * temp43 * cosio * sinio * cos2u;
-   const double rdotk = rdot - xn * temp42 * x1mth2 * sin2u;
-   const double rfdotk = rfdot + xn * temp42 * ( x1mth2 * cos2u + 1.5 * x3thm1 );
+   const T temp41 = T( 1.0 ) / pl;
+   const T temp42 = T( kCK2 ) * temp41;
+   const T temp43 = temp42 * temp41;
+
+   const T rk = r * ( T( 1.0 ) - T( 1.5 ) * temp43 * betal * x3thm1 )
+                + T( 0.5 ) * temp42 * x1mth2 * cos2u;
+   const T uk = u - T( 0.25 ) * temp43 * x7thm1 * sin2u;
+   const T xnodek = xnode + T( 1.5 ) * temp43 * cosio * sin2u;
+   const T xinck = xinc + T( 1.5 ) * temp43 * cosio * sinio * cos2u;
+   const T rdotk = rdot - xn * temp42 * x1mth2 * sin2u;
+   const T rfdotk = rfdot + xn * temp42 * ( x1mth2 * cos2u + T( 1.5 ) * x3thm1 );
 
    /*
     * orientation vectors
     */
-   const double sinuk = sin( uk );
-   const double cosuk = cos( uk );
-   const double sinik = sin( xinck );
-   const double cosik = cos( xinck );
-   const double sinnok = sin( xnodek );
-   const double cosnok = cos( xnodek );
-   const double xmx = -sinnok * cosik;
-   const double xmy = cosnok * cosik;
-   const double ux = xmx * sinuk + cosnok * cosuk;
-   const double uy = xmy * sinuk + sinnok * cosuk;
-   const double uz = sinik * sinuk;
-   const double vx = xmx * cosuk - cosnok * sinuk;
-   const double vy = xmy * cosuk - sinnok * sinuk;
-   const double vz = sinik * cosuk;
+   const T sinuk = std::sin( uk );
+   const T cosuk = std::cos( uk );
+   const T sinik = std::sin( xinck );
+   const T cosik = std::cos( xinck );
+   const T sinnok = std::sin( xnodek );
+   const T cosnok = std::cos( xnodek );
+   const T xmx = -sinnok * cosik;
+   const T xmy = cosnok * cosik;
+   const T ux = xmx * sinuk + cosnok * cosuk;
+   const T uy = xmy * sinuk + sinnok * cosuk;
+   const T uz = sinik * sinuk;
+   const T vx = xmx * cosuk - cosnok * sinuk;
+   const T vy = xmy * cosuk - sinnok * sinuk;
+   const T vz = sinik * cosuk;
    /*
     * position and velocity
     */
-   const double x = rk * ux * kXKMPER;
-   const double y = rk * uy * kXKMPER;
-   const double z = rk * uz * kXKMPER;
-   Vector position( x, y, z );
-   const double xdot = ( rdotk * ux + rfdotk * vx ) * kXKMPER / 60.0;
-   const double ydot = ( rdotk * uy + rfdotk * vy ) * kXKMPER / 60.0;
-   const double zdot = ( rdotk * uz + rfdotk * vz ) * kXKMPER / 60.0;
-   Vector velocity( xdot, ydot, zdot );
-
-   if ( rk < 1.0 )
+   position[0] = rk * ux * T( kXKMPER );
+   position[1] = rk * uy * T( kXKMPER );
+   position[2] = rk * uz * T( kXKMPER );
+   velocity[0] = ( rdotk * ux + rfdotk * vx ) * T( kXKMPER ) / T( 60.0 );
+   velocity[1] = ( rdotk * uy + rfdotk * vy ) * T( kXKMPER ) / T( 60.0 );
+   velocity[2] = ( rdotk * uz + rfdotk * vz ) * T( kXKMPER ) / T( 60.0 );
+
+   return rk < T( 1.0 ) ? PropagationStatus::DECAYED : PropagationStatus::OK;
+}
+} // namespace
+
+FloatStateVector SGP4::FindPositionFloat( double tsince ) const
+{
+   FloatStateVector state;
+   const PropagationStatus status = PropagateFloat( tsince, state );
+   if ( status == PropagationStatus::OK )
+   {
+      return state;
+   }
+   if ( status == PropagationStatus::DECAYED )
    {
       throw DecayedException(
-         dt,
-         position,
-         velocity );
+         elements_.Epoch().AddMinutes( tsince ),
+         Vector( state.position[0], state.position[1], state.position[2] ),
+         Vector( state.velocity[0], state.velocity[1], state.velocity[2] ) );
+   }
+   throw SatelliteException( ToString( status ) );
+}
+
+PropagationStatus SGP4::PropagateFloat( double tsince,
+                                        FloatStateVector& state ) const noexcept
+{
+   if ( use_deep_space_ )
+   {
+      Vector3 position;
+      Vector3 velocity;
+      const PropagationStatus status = Propagate( tsince, position, velocity );
+      state.position[0] = static_cast<float>( position.x );
+      state.position[1] = static_cast<float>( position.y );
+      state.position[2] = static_cast<float>( position.z );
+      state.velocity[0] = static_cast<float>( velocity.x );
+      state.velocity[1] = static_cast<float>( velocity.y );
+      state.velocity[2] = static_cast<float>( velocity.z );
+      return status;
+   }
+
+   SGP4_COUNT( near_earth_calls );
+   SGP4_INSTRUMENT( if ( use_simple_model_ ) SGP4_COUNT( simple_calls ); )
+
+   double e;
+   double a;
+   double omega;
+   double xl;
+   double xnode;
+   const PropagationStatus status = NearEarthSecular( tsince, e, a, omega, xl, xnode );
+   if ( status != PropagationStatus::OK )
+   {
+      return status;
+   }
+
+   /*
+    * the secular angles grow without bound, so reduce them while still in
+    * double precision
+    */
+   return FinalPositionVelocity(
+             static_cast<float>( e ),
+             static_cast<float>( a ),
+             static_cast<float>( Util::WrapTwoPI( omega ) ),
+             static_cast<float>( Util::WrapTwoPI( xl ) ),
+             static_cast<float>( Util::WrapTwoPI( xnode ) ),
+             static_cast<float>( elements_.Inclination() ),
+             static_cast<float>( common_consts_.xlcof ),
+             static_cast<float>( common_consts_.aycof ),
+             static_cast<float>( common_consts_.x3thm1 ),
+             static_cast<float>( common_consts_.x1mth2 ),
+             static_cast<float>( common_consts_.x7thm1 ),
+             static_cast<float>( common_consts_.cosio ),
+             static_cast<float>( common_consts_.sinio ),
+             state.position,
+             state.velocity );
+}
+
+size_t SGP4::FindPositions( const double* tsince,
+                            const size_t count,
+                            PositionBuffer& buffer ) const
+{
+   SGP4_TRACE_SCOPE( "SGP4::FindPositions" );
+
+   buffer.Resize( count );
+   double* x = buffer.Data( PositionBuffer::X );
+   double* y = buffer.Data( PositionBuffer::Y );
+   double* z = buffer.Data( PositionBuffer::Z );
+   double* xdot = buffer.Data( PositionBuffer::XDOT );
+   double* ydot = buffer.Data( PositionBuffer::YDOT );
+   double* zdot = buffer.Data( PositionBuffer::ZDOT );
+   PropagationStatus* statuses = buffer.Status();
+
+   if ( use_deep_space_ )
+   {
+      SGP4_COUNT_ADD( deep_space_calls, count );
+   }
+   else
+   {
+      SGP4_COUNT_ADD( near_earth_calls, count );
+      SGP4_INSTRUMENT( if ( use_simple_model_ ) SGP4_COUNT_ADD( simple_calls, count ); )
    }
 
-   return Eci( dt, position, velocity );
+   size_t failed = 0;
+   for ( size_t i = 0; i < count; i++ )
+   {
+      double p[3] = {};
+      double v[3] = {};
+      const PropagationStatus status = use_deep_space_
+                                       ? PropagateSDP4( tsince[i], p, v )
+                                       : PropagateSGP4( tsince[i], p, v );
+      if ( status != PropagationStatus::OK )
+      {
+         failed++;
+      }
+
+      x[i] = p[0];
+      y[i] = p[1];
+      z[i] = p[2];
+      xdot[i] = v[0];
+      ydot[i] = v[1];
+      zdot[i] = v[2];
+      statuses[i] = status;
+   }
+
+   return failed;
 }
 
 static inline double EvaluateCubicPolynomial(
@@ -1074,6 +1495,15 @@ void SGP4::DeepSpaceInitialise(
        * initialise integrator
        */
       deepspace_consts_.xfact = bfact - elements_.RecoveredMeanMotion();
+      ResetIntegrator();
+   }
+}
+
+void SGP4::ResetIntegrator()
+{
+   std::memset( &integrator_params_, 0, sizeof( integrator_params_ ) );
+   if ( use_deep_space_ && deepspace_consts_.shape != DeepSpaceConstants::NONE )
+   {
       integrator_params_.atime = 0.0;
       integrator_params_.xni = elements_.RecoveredMeanMotion();
       integrator_params_.xli = deepspace_consts_.xlamo;
@@ -1255,6 +1685,7 @@ void SGP4::DeepSpaceSecular(
             fabs( tsince ) < fabs( integ_params.atime ) )
       {
          // restart back at the epoch
+         SGP4_COUNT( integrator_restarts );
          integ_params.atime = 0.0;
          // TODO: check
          integ_params.xni = elements.RecoveredMeanMotion();
@@ -1262,6 +1693,7 @@ void SGP4::DeepSpaceSecular(
          integ_params.xli = ds_constants.xlamo;
       }
 
+      SGP4_INSTRUMENT( uint64_t steps = 0; )
       bool running = true;
       while ( running )
       {
@@ -1315,6 +1747,7 @@ void SGP4::DeepSpaceSecular(
             integ_params.xli = integ_params.xli + xldot * delt + xndot * STEP2;
             integ_params.xni = integ_params.xni + xndot * delt + xnddt * STEP2;
             integ_params.atime += delt;
+            SGP4_INSTRUMENT( steps++; )
          }
          else
          {
@@ -1334,6 +1767,8 @@ void SGP4::DeepSpaceSecular(
                xll = xl_temp + 2.0 * ( theta - xnodes );
             }
             running = false;
+            SGP4_COUNT_ADD( integrator_steps_total, steps );
+            SGP4_HISTOGRAM( integrator_steps, Instrumentation::Log2Bin( steps ) );
          }
       }
    }
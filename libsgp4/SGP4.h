@@ -19,9 +19,14 @@
 #include "DecayedException.h"
 #include "Eci.h"
 #include "OrbitalElements.h"
+#include "PositionBuffer.h"
+#include "PropagationStatus.h"
 #include "SatelliteException.h"
 #include "Tle.h"
 
+#include <cstdint>
+#include <vector>
+
 namespace libsgp4
 {
 
@@ -31,6 +36,17 @@ namespace libsgp4
  * This documents the SGP4 tracking library.
  */
 
+/**
+ * @brief A state vector in single precision.
+ */
+struct FloatStateVector
+{
+   /** position in km */
+   float position[3];
+   /** velocity in km/s */
+   float velocity[3];
+};
+
 /**
  * @brief The simplified perturbations model 4 propagator.
  */
@@ -39,10 +55,125 @@ class SGP4
 public:
    explicit SGP4( const Tle &tle ) : elements_( tle ) { Initialise(); }
 
+   /**
+    * Construct from a state saved by SaveState, skipping the
+    * initialisation. Falls back to initialising when the state is not of
+    * this tle or not from this build of the library.
+    * @param[in] tle the element set
+    * @param[in] state the saved state
+    */
+   SGP4( const Tle &tle, const std::vector<char> &state );
+
    void SetTle( const Tle &tle );
+
+   /**
+    * @param[in] tle the element set
+    * @returns a 64 bit FNV-1a hash of the elements, which keys saved
+    * states; a state is only restored for the elements it was saved for,
+    * so colliding hashes cost a miss rather than wrong constants
+    */
+   static uint64_t Fingerprint( const Tle &tle );
+
+   /**
+    * Save the initialised state: the constants, the flags and the
+    * elements they were initialised from. The layout is that of the build, in host
+    * byte order, so it is meant for caches rather than for exchange.
+    * @returns the state
+    */
+   std::vector<char> SaveState() const;
+
+   /**
+    * Restore a state saved by SaveState, skipping the initialisation
+    * @param[in] tle the element set the state was saved for
+    * @param[in] state the saved state
+    * @returns false, leaving the propagator unchanged, if the state is not
+    * of this tle or not from this build of the library
+    */
+   bool RestoreState( const Tle &tle, const std::vector<char> &state );
+
+   /**
+    * @param[in] tle the element set
+    * @param[in] state a saved state
+    * @returns whether RestoreState would accept the state for the tle
+    */
+   static bool IsStateOf( const Tle &tle, const std::vector<char> &state );
+
    Eci FindPosition( double tsince ) const;
    Eci FindPosition( const DateTime &date ) const;
 
+   /**
+    * Propagate without exceptions. FindPosition wraps this, throwing
+    * DecayedException for DECAYED and SatelliteException with the message
+    * ToString gives for the other failures.
+    * @param[in] tsince minutes since epoch
+    * @param[out] position in km, set when the status is OK or DECAYED
+    * @param[out] velocity in km/s, set when the status is OK or DECAYED
+    * @returns the status
+    */
+   PropagationStatus Propagate( double tsince, Vector3 &position,
+                                Vector3 &velocity ) const noexcept;
+
+   /**
+    * Propagate without exceptions to a time, as FindPosition( date ) does
+    * @param[in] date the time
+    * @param[out] eci the position and velocity, set when the status is OK
+    * or DECAYED
+    * @returns the status
+    */
+   PropagationStatus Propagate( const DateTime &date, Eci &eci ) const noexcept;
+
+   /**
+    * Propagate in single precision, for workloads that need throughput more
+    * than accuracy. The secular terms are evaluated in double precision and
+    * their angles reduced to [0, 2pi) before the rest of the model runs in
+    * float, so the error does not grow with tsince the way a float time
+    * would; deep space objects use the double model and are converted.
+    * Against FindPosition the error is set by float rounding, not tsince:
+    * for low earth orbits it stayed below 12 m and 12 mm/s on every day of
+    * the first week from epoch, and over the SGP4-VER.TLE cases it is 8 m
+    * at most and 2 m RMS (runtest --compare).
+    * @param[in] tsince minutes since epoch
+    * @returns the state vector
+    * @exception SatelliteException, DecayedException as FindPosition
+    */
+   FloatStateVector FindPositionFloat( double tsince ) const;
+
+   /**
+    * FindPositionFloat without exceptions, as Propagate
+    * @param[in] tsince minutes since epoch
+    * @param[out] state set when the status is OK or DECAYED
+    * @returns the status
+    */
+   PropagationStatus PropagateFloat( double tsince,
+                                     FloatStateVector &state ) const noexcept;
+
+   /**
+    * Propagate a batch of times, straight into structure of arrays storage
+    * without building an Eci per sample. The results match FindPosition.
+    * A failed sample does not stop the batch: each gets its own status,
+    * and its state vector is zero unless the status is OK or DECAYED.
+    * @param[in] tsince minutes since epoch of each sample
+    * @param[in] count the number of samples
+    * @param[out] buffer resized to count and filled in order
+    * @returns the number of samples whose status is not OK
+    * @exception std::bad_alloc if the buffer cannot grow to count
+    */
+   size_t FindPositions( const double *tsince, size_t count,
+                         PositionBuffer &buffer ) const;
+
+   /**
+    * @returns the orbital elements the propagator was initialised with
+    */
+   const OrbitalElements& GetOrbitalElements() const
+   {
+      return elements_;
+   }
+
+   /**
+    * @returns the Fingerprint of the tle the propagator was initialised with
+    */
+   uint64_t GetFingerprint() const;
+
 private:
    struct CommonConstants
    {
@@ -160,14 +291,13 @@ private:
    static void RecomputeConstants( const double xinc, double &sinio,
                                    double &cosio, double &x3thm1, double &x1mth2,
                                    double &x7thm1, double &xlcof, double &aycof );
-   Eci FindPositionSDP4( const double tsince ) const;
-   Eci FindPositionSGP4( double tsince ) const;
-   static Eci CalculateFinalPositionVelocity(
-      const DateTime &date, const double e, const double a, const double omega,
-      const double xl, const double xnode, const double xinc,
-      const double xlcof, const double aycof, const double x3thm1,
-      const double x1mth2, const double x7thm1, const double cosio,
-      const double sinio );
+   PropagationStatus PropagateSDP4( const double tsince, double position[3],
+                                    double velocity[3] ) const noexcept;
+   PropagationStatus PropagateSGP4( const double tsince, double position[3],
+                                    double velocity[3] ) const noexcept;
+   PropagationStatus NearEarthSecular( const double tsince, double &e,
+                                       double &a, double &omega, double &xl,
+                                       double &xnode ) const noexcept;
    /**
     * Deep space initialisation
     */
@@ -199,6 +329,24 @@ private:
     */
    void Reset();
 
+   /**
+    * Start the deep space integrator at epoch
+    */
+   void ResetIntegrator();
+
+   /**
+    * @returns where the flags and constants start in a saved state, or
+    * nullptr if the state is not of the elements or not from this build
+    */
+   static const char *CheckState( const std::vector<char> &state,
+                                  const OrbitalElements &elements );
+
+   /**
+    * Load the flags and constants of a checked state; the elements must
+    * already be those of its tle
+    */
+   void LoadState( const char *p );
+
    /*
     * the constants used
     */
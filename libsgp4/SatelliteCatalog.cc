@@ -0,0 +1,147 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "SatelliteCatalog.h"
+
+#include "Tracing.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * element sets a worker claims at a time; small enough to balance the
+ * cheap near earth and the dearer deep space initialisations, large enough
+ * that the shared counter is rarely touched
+ */
+const size_t kChunkSize = 64;
+} // namespace
+
+SatelliteCatalog::SatelliteCatalog( std::vector<Tle> tles )
+   : m_tles( std::move( tles ) )
+   , m_slots( new Slot[m_tles.size()] )
+{
+   m_index.reserve( m_tles.size() );
+   for ( size_t i = 0; i < m_tles.size(); i++ )
+   {
+      m_index[m_tles[i].NoradNumber()] = i;
+   }
+}
+
+size_t SatelliteCatalog::Find( const unsigned int norad_number ) const
+{
+   const auto itr = m_index.find( norad_number );
+   return itr == m_index.end() ? m_tles.size() : itr->second;
+}
+
+const SGP4& SatelliteCatalog::Get( const size_t index )
+{
+   Slot& slot = Initialise( index );
+   if ( slot.error )
+   {
+      std::rethrow_exception( slot.error );
+   }
+   return *slot.sgp4;
+}
+
+SatelliteCatalog::Slot& SatelliteCatalog::Initialise( const size_t index )
+{
+   Slot& slot = m_slots[index];
+   std::call_once( slot.once, [this, &slot, index]()
+   {
+      /*
+       * keep the error rather than letting call_once retry, so invalid
+       * elements are not initialised again on every call
+       */
+      try
+      {
+         slot.sgp4.emplace( m_tles[index] );
+         slot.ready.store( true, std::memory_order_release );
+         m_initialised.fetch_add( 1, std::memory_order_relaxed );
+      }
+      catch ( ... )
+      {
+         slot.error = std::current_exception();
+      }
+   } );
+   return slot;
+}
+
+size_t SatelliteCatalog::InitialiseAll( unsigned int threads )
+{
+   SGP4_TRACE_SCOPE( "SatelliteCatalog::InitialiseAll" );
+
+   if ( threads == 0 )
+   {
+      threads = std::max( 1U, std::thread::hardware_concurrency() );
+   }
+   const size_t chunks = ( m_tles.size() + kChunkSize - 1 ) / kChunkSize;
+   threads = static_cast<unsigned int>( std::min<size_t>( threads, chunks ) );
+
+   /*
+    * workers claim chunks from a shared counter, so one slowed down by
+    * deep space element sets does not hold up the rest
+    */
+   std::atomic<size_t> next{ 0 };
+   auto work = [this, &next]()
+   {
+      SGP4_TRACE_SCOPE( "SatelliteCatalog::InitialiseAll/worker" );
+      for ( ;; )
+      {
+         const size_t begin = next.fetch_add( kChunkSize, std::memory_order_relaxed );
+         if ( begin >= m_tles.size() )
+         {
+            break;
+         }
+         const size_t end = std::min( begin + kChunkSize, m_tles.size() );
+         for ( size_t i = begin; i < end; i++ )
+         {
+            Initialise( i );
+         }
+      }
+   };
+
+   /*
+    * the calling thread is one of the workers
+    */
+   std::vector<std::thread> pool;
+   for ( unsigned int t = 1; t < threads; t++ )
+   {
+      pool.emplace_back( work );
+   }
+   work();
+   for ( auto& thread : pool )
+   {
+      thread.join();
+   }
+
+   size_t failed = 0;
+   for ( size_t i = 0; i < m_tles.size(); i++ )
+   {
+      if ( m_slots[i].error )
+      {
+         failed++;
+      }
+   }
+   return failed;
+}
+
+} // namespace libsgp4
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "SGP4.h"
+#include "Tle.h"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief A catalog of element sets whose propagators are initialised on
+ * first use.
+ *
+ * Building the catalog only stores the element sets, so startup costs in
+ * proportion to the objects a run actually propagates. Get initialises a
+ * propagator exactly once however many threads ask for it at the same time;
+ * InitialiseAll instead initialises the whole catalog up front, split over a
+ * pool of threads, for runs that will use most of it.
+ *
+ * The set of element sets is fixed at construction, so references returned
+ * by Get stay valid for the life of the catalog. Initialisation is thread
+ * safe; propagation is as thread safe as SGP4 itself, which means a deep
+ * space propagator must not be used by several threads at once; copy it
+ * instead.
+ */
+class SatelliteCatalog
+{
+public:
+   /**
+    * @param[in] tles the element sets; none is initialised yet
+    */
+   explicit SatelliteCatalog( std::vector<Tle> tles );
+
+   SatelliteCatalog( const SatelliteCatalog& ) = delete;
+   SatelliteCatalog& operator=( const SatelliteCatalog& ) = delete;
+
+   /**
+    * @returns the number of element sets
+    */
+   size_t Size() const
+   {
+      return m_tles.size();
+   }
+
+   /**
+    * @param[in] index the element set index
+    * @returns the element set
+    */
+   const Tle& GetTle( const size_t index ) const
+   {
+      return m_tles[index];
+   }
+
+   /**
+    * Find an element set by its catalog number
+    * @param[in] norad_number the catalog number
+    * @returns the index of the last element set with the number, or Size()
+    * if there is none
+    */
+   size_t Find( unsigned int norad_number ) const;
+
+   /**
+    * Get a propagator, initialising it on the first call
+    * @param[in] index the element set index
+    * @returns the propagator
+    * @exception SatelliteException if the elements are invalid; every call
+    * for the element set throws it again
+    */
+   const SGP4& Get( size_t index );
+
+   /**
+    * @param[in] index the element set index
+    * @returns whether the propagator has been initialised successfully
+    */
+   bool Initialised( const size_t index ) const
+   {
+      return m_slots[index].ready.load( std::memory_order_acquire );
+   }
+
+   /**
+    * @returns the number of propagators initialised successfully
+    */
+   size_t InitialisedCount() const
+   {
+      return m_initialised.load( std::memory_order_relaxed );
+   }
+
+   /**
+    * Initialise every propagator not yet initialised, splitting the catalog
+    * over a pool of threads. Safe to call while other threads call Get.
+    * @param[in] threads the number of threads; 0 uses one per hardware
+    * thread
+    * @returns the number of element sets that failed to initialise
+    */
+   size_t InitialiseAll( unsigned int threads = 0 );
+
+private:
+   /*
+    * the lazily initialised state of one element set
+    */
+   struct Slot
+   {
+      std::once_flag once;
+      std::optional<SGP4> sgp4;
+      std::exception_ptr error;
+      std::atomic<bool> ready{ false };
+   };
+
+   /**
+    * Initialise a propagator if no thread has yet
+    * @param[in] index the element set index
+    * @returns the slot, holding the propagator or the error
+    */
+   Slot& Initialise( size_t index );
+
+   /** the element sets */
+   std::vector<Tle> m_tles;
+   /** a slot per element set */
+   std::unique_ptr<Slot[]> m_slots;
+   /** element set index by catalog number */
+   std::unordered_map<unsigned int, size_t> m_index;
+   /** propagators initialised successfully */
+   std::atomic<size_t> m_initialised{ 0 };
+};
+
+} // namespace libsgp4
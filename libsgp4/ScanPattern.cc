@@ -0,0 +1,279 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ScanPattern.h"
+
+#include "Globals.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * smallest cos(el) used to turn cross-elevation into azimuth, so a scan
+ * near the zenith does not ask for an unbounded azimuth offset
+ */
+const double kMinimumCosElevation = 0.01;
+
+/*
+ * Newton iteration limit for the spiral angle
+ */
+const int kMaxIterations = 50;
+}
+
+ScanPattern::ScanPattern( const ScanParameters& parameters )
+   : m_parameters( parameters )
+{
+   const double radius = m_parameters.radius;
+
+   if ( radius <= 0.0 || m_parameters.speed <= 0.0 )
+   {
+      throw std::invalid_argument( "Scan radius and speed must be positive" );
+   }
+
+   switch ( m_parameters.type )
+   {
+   case ScanType::SPIRAL:
+      if ( m_parameters.spacing <= 0.0
+            || m_parameters.inner_radius < 0.0
+            || m_parameters.inner_radius >= radius )
+      {
+         throw std::invalid_argument( "Invalid spiral spacing or inner radius" );
+      }
+      m_spiral_a = m_parameters.spacing / kTWOPI;
+      m_spiral_outer = SpiralLength( radius / m_spiral_a );
+      m_length = m_spiral_outer
+                 - SpiralLength( m_parameters.inner_radius / m_spiral_a );
+      break;
+   case ScanType::CONICAL:
+      m_length = kTWOPI * radius;
+      break;
+   case ScanType::DIAMOND:
+      m_length = 4.0 * std::sqrt( 2.0 ) * radius;
+      break;
+   case ScanType::RASTER:
+      if ( m_parameters.spacing <= 0.0 )
+      {
+         throw std::invalid_argument( "Invalid raster spacing" );
+      }
+      m_raster_lines = static_cast<size_t>(
+                          std::floor( 2.0 * radius / m_parameters.spacing ) ) + 1;
+      m_length = static_cast<double>( m_raster_lines ) * 2.0 * radius
+                 + static_cast<double>( m_raster_lines - 1 ) * m_parameters.spacing;
+      break;
+   }
+}
+
+double ScanPattern::SpiralLength( const double angle ) const
+{
+   return 0.5 * m_spiral_a * ( angle * std::sqrt( 1.0 + angle * angle )
+                               + std::asinh( angle ) );
+}
+
+ScanOffset ScanPattern::Evaluate( const double arc, double& angle ) const
+{
+   const double radius = m_parameters.radius;
+   const double speed = m_parameters.speed;
+   ScanOffset offset{};
+
+   switch ( m_parameters.type )
+   {
+   case ScanType::SPIRAL:
+   {
+      /*
+       * the spiral runs inwards, so find the angle whose arc length from
+       * the centre is what is left of the path
+       */
+      const double target = m_spiral_outer - arc;
+      const double inner = m_parameters.inner_radius / m_spiral_a;
+      const double outer = radius / m_spiral_a;
+      double phi = std::min( std::max( angle, inner ), outer );
+      for ( int i = 0; i < kMaxIterations; i++ )
+      {
+         const double step = ( SpiralLength( phi ) - target )
+                             / ( m_spiral_a * std::sqrt( 1.0 + phi * phi ) );
+         phi = std::max( phi - step, 0.0 );
+         if ( std::fabs( step ) <= 1e-13 * ( 1.0 + phi ) )
+         {
+            break;
+         }
+      }
+      angle = phi;
+
+      const double r = m_spiral_a * phi;
+      const double sin_phi = std::sin( phi );
+      const double cos_phi = std::cos( phi );
+      const double tangent = std::sqrt( 1.0 + phi * phi );
+      offset.cross_elevation = r * cos_phi;
+      offset.elevation = r * sin_phi;
+      offset.cross_elevation_rate = -speed * ( cos_phi - phi * sin_phi ) / tangent;
+      offset.elevation_rate = -speed * ( sin_phi + phi * cos_phi ) / tangent;
+      break;
+   }
+   case ScanType::CONICAL:
+   {
+      /*
+       * clockwise from the top of the circle
+       */
+      const double theta = arc / radius;
+      offset.cross_elevation = radius * std::sin( theta );
+      offset.elevation = radius * std::cos( theta );
+      offset.cross_elevation_rate = speed * std::cos( theta );
+      offset.elevation_rate = -speed * std::sin( theta );
+      break;
+   }
+   case ScanType::DIAMOND:
+   {
+      /*
+       * top, right, bottom, left and back to the top
+       */
+      static const double kCornerX[] = { 0.0, 1.0, 0.0, -1.0, 0.0 };
+      static const double kCornerY[] = { 1.0, 0.0, -1.0, 0.0, 1.0 };
+      const double edge = std::sqrt( 2.0 ) * radius;
+      const size_t k = std::min<size_t>( static_cast<size_t>( arc / edge ), 3 );
+      const double u = ( arc - static_cast<double>( k ) * edge ) / edge;
+      const double dx = kCornerX[k + 1] - kCornerX[k];
+      const double dy = kCornerY[k + 1] - kCornerY[k];
+      offset.cross_elevation = radius * ( kCornerX[k] + u * dx );
+      offset.elevation = radius * ( kCornerY[k] + u * dy );
+      offset.cross_elevation_rate = speed * dx / std::sqrt( 2.0 );
+      offset.elevation_rate = speed * dy / std::sqrt( 2.0 );
+      break;
+   }
+   case ScanType::RASTER:
+   {
+      /*
+       * each line across is followed by a step down to the next line,
+       * alternating direction
+       */
+      const double line = 2.0 * radius;
+      const double spacing = m_parameters.spacing;
+      const size_t k = std::min( static_cast<size_t>( arc / ( line + spacing ) ),
+                                 m_raster_lines - 1 );
+      const double along = arc - static_cast<double>( k ) * ( line + spacing );
+      const double direction = k % 2 == 0 ? 1.0 : -1.0;
+      const double top = radius - static_cast<double>( k ) * spacing;
+      if ( along <= line || k == m_raster_lines - 1 )
+      {
+         offset.cross_elevation = direction * ( std::min( along, line ) - radius );
+         offset.elevation = top;
+         offset.cross_elevation_rate = direction * speed;
+      }
+      else
+      {
+         offset.cross_elevation = direction * radius;
+         offset.elevation = top - ( along - line );
+         offset.elevation_rate = -speed;
+      }
+      break;
+   }
+   }
+
+   return offset;
+}
+
+ScanOffset ScanPattern::OffsetAt( const double seconds ) const
+{
+   const double arc = std::min( std::max( seconds, 0.0 ), Duration() )
+                      * m_parameters.speed;
+
+   /*
+    * far from the centre the spiral length grows as a phi^2 / 2, a close
+    * enough start for Newton
+    */
+   double angle = 0.0;
+   if ( m_parameters.type == ScanType::SPIRAL )
+   {
+      angle = std::sqrt( 2.0 * ( m_spiral_outer - arc ) / m_spiral_a );
+   }
+   return Evaluate( arc, angle );
+}
+
+void ScanPattern::Start( const DateTime& start, const double rate )
+{
+   m_track = nullptr;
+   m_start = start.Ticks();
+   m_interval = TicksPerSecond / rate;
+   m_count = static_cast<size_t>( std::floor( Duration() * rate ) ) + 1;
+   m_next = 0;
+   m_angle = m_parameters.type == ScanType::SPIRAL
+             ? m_parameters.radius / m_spiral_a : 0.0;
+}
+
+void ScanPattern::Start( const TrajectoryGenerator& track,
+                         const DateTime& start,
+                         const double rate )
+{
+   Start( start, rate );
+   m_track = &track;
+}
+
+size_t ScanPattern::Fill( PointingCommand* buffer, const size_t capacity )
+{
+   size_t written = 0;
+
+   while ( written < capacity && m_next < m_count )
+   {
+      const double seconds = static_cast<double>( m_next ) * m_interval
+                             / TicksPerSecond;
+      const double arc = std::min( seconds * m_parameters.speed, m_length );
+
+      /*
+       * consecutive samples start Newton from the previous spiral angle
+       */
+      const ScanOffset offset = Evaluate( arc, m_angle );
+      const int64_t ticks = m_start + static_cast<int64_t>(
+                               std::llround( static_cast<double>( m_next ) * m_interval ) );
+
+      PointingCommand& command = buffer[written];
+      if ( m_track == nullptr )
+      {
+         command.ticks = ticks;
+         command.azimuth = offset.cross_elevation;
+         command.elevation = offset.elevation;
+         command.azimuth_rate = offset.cross_elevation_rate;
+         command.elevation_rate = offset.elevation_rate;
+      }
+      else
+      {
+         command = m_track->Interpolate( ticks );
+         const double sin_el = std::sin( command.elevation );
+         const double cos_el = std::max( std::cos( command.elevation ),
+                                         kMinimumCosElevation );
+         command.azimuth = Util::WrapTwoPI( command.azimuth
+                                            + offset.cross_elevation / cos_el );
+         command.azimuth_rate += offset.cross_elevation_rate / cos_el
+                                 + offset.cross_elevation * sin_el
+                                 * command.elevation_rate / ( cos_el * cos_el );
+         command.elevation += offset.elevation;
+         command.elevation_rate += offset.elevation_rate;
+      }
+
+      written++;
+      m_next++;
+   }
+
+   return written;
+}
+
+} // namespace libsgp4
@@ -0,0 +1,185 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "DateTime.h"
+#include "PointingCommand.h"
+#include "TrajectoryGenerator.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libsgp4
+{
+
+/**
+ * @brief The shape of a scan.
+ */
+enum class ScanType
+{
+   /** Archimedean (cochlear) spiral from the outer radius inwards */
+   SPIRAL,
+   /** one circle at the radius */
+   CONICAL,
+   /** the square with corners on the axes at the radius */
+   DIAMOND,
+   /** alternating cross-elevation lines from the top of the radius down */
+   RASTER
+};
+
+/**
+ * @brief Parameters of a scan. Angles are in radians on the sky and the
+ * speed in radians per second along the path.
+ */
+struct ScanParameters
+{
+   ScanType type{ ScanType::SPIRAL };
+   /** outer radius */
+   double radius{};
+   /** radius the spiral ends at */
+   double inner_radius{};
+   /** distance between spiral turns, or between raster lines */
+   double spacing{};
+   /** speed along the path */
+   double speed{};
+};
+
+/**
+ * @brief An offset from the track, in cross-elevation and elevation, with
+ * its rate.
+ */
+struct ScanOffset
+{
+   double cross_elevation;
+   double elevation;
+   double cross_elevation_rate;
+   double elevation_rate;
+};
+
+/**
+ * @brief Generates a scan around a point or a predicted track.
+ *
+ * The path is traversed at constant speed: the position along it is found
+ * from the exact arc length at each sample, so samples are evenly spaced on
+ * the sky. Superimposed on a track, cross-elevation offsets are turned into
+ * azimuth offsets by dividing by cos(el).
+ *
+ * Commands are streamed into a caller's buffer by Fill, which picks up where
+ * the previous call stopped, so a scan can be fed to a controller in blocks
+ * of any size without allocating.
+ */
+class ScanPattern
+{
+public:
+   /**
+    * Constructor
+    * @param[in] parameters the scan
+    */
+   explicit ScanPattern( const ScanParameters& parameters );
+
+   /**
+    * @returns the time to traverse the whole path in seconds
+    */
+   double Duration() const
+   {
+      return m_length / m_parameters.speed;
+   }
+
+   /**
+    * Get the offset at a time into the scan
+    * @param[in] seconds time since the start of the scan, clamped to the
+    * duration
+    * @returns the offset
+    */
+   ScanOffset OffsetAt( const double seconds ) const;
+
+   /**
+    * Start streaming the offsets alone, as commands whose azimuth and
+    * elevation are the cross-elevation and elevation offsets
+    * @param[in] start time of the first command
+    * @param[in] rate commands per second
+    */
+   void Start( const DateTime& start, const double rate );
+
+   /**
+    * Start streaming the scan superimposed on a track
+    * @param[in] track the prepared track, must outlive the scan
+    * @param[in] start time of the first command
+    * @param[in] rate commands per second
+    */
+   void Start( const TrajectoryGenerator& track,
+               const DateTime& start,
+               const double rate );
+
+   /**
+    * Write the next commands of the scan
+    * @param[out] buffer receives the commands
+    * @param[in] capacity size of the buffer
+    * @returns the number of commands written, zero once the scan is done
+    */
+   size_t Fill( PointingCommand* buffer, const size_t capacity );
+
+   /**
+    * @returns whether every command of the scan has been written
+    */
+   bool Done() const
+   {
+      return m_next >= m_count;
+   }
+
+private:
+   /**
+    * @param[in] arc distance along the path from its start
+    * @param[in,out] angle spiral angle, used as the first guess and
+    * updated; ignored by the other shapes
+    * @returns the offset
+    */
+   ScanOffset Evaluate( const double arc, double& angle ) const;
+
+   /**
+    * Arc length of the spiral r = a phi from its centre
+    * @param[in] angle the spiral angle phi
+    * @returns the arc length
+    */
+   double SpiralLength( const double angle ) const;
+
+   ScanParameters m_parameters;
+   /** length of the whole path */
+   double m_length{};
+   /** spiral: radius gained per radian */
+   double m_spiral_a{};
+   /** spiral: arc length from the centre to the outer radius */
+   double m_spiral_outer{};
+   /** raster: number of lines */
+   size_t m_raster_lines{};
+
+   /** track the scan is superimposed on, if any */
+   const TrajectoryGenerator* m_track{};
+   /** ticks of the first command */
+   int64_t m_start{};
+   /** ticks between commands */
+   double m_interval{};
+   /** commands in the whole scan */
+   size_t m_count{};
+   /** next command to write */
+   size_t m_next{};
+   /** spiral angle of the last command written */
+   double m_angle{};
+};
+
+} // namespace libsgp4
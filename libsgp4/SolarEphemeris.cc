@@ -0,0 +1,188 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "SolarEphemeris.h"
+
+#include "SolarPosition.h"
+
+#include <algorithm>
+#include <mutex>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * half width of the central difference used for the node rates
+ */
+const double kRateStepSeconds = 60.0;
+}
+
+SolarEphemeris::SolarEphemeris( const DateTime& start,
+                                const DateTime& end,
+                                const TimeSpan& spacing )
+   : m_start( start.Ticks() )
+   , m_spacing( std::max<int64_t>( spacing.Ticks(), 1 ) )
+{
+   Build( end.Ticks(), nullptr );
+}
+
+SolarEphemeris::SolarEphemeris( const int64_t start,
+                                const int64_t end,
+                                const SolarEphemeris& previous )
+   : m_start( start )
+   , m_spacing( previous.m_spacing )
+{
+   Build( end, &previous );
+}
+
+void SolarEphemeris::Build( const int64_t end, const SolarEphemeris* previous )
+{
+   const int64_t span = std::max<int64_t>( end - m_start, 0 );
+   const int64_t intervals = ( span + m_spacing - 1 ) / m_spacing;
+   const size_t count = static_cast<size_t>( intervals ) + 1;
+   m_end = m_start + intervals * m_spacing;
+
+   m_positions.reserve( count );
+   m_rates.reserve( count );
+
+   SolarPosition solar_position;
+   const double scale = static_cast<double>( m_spacing ) / TicksPerSecond
+                        / ( 2.0 * kRateStepSeconds );
+
+   for ( size_t i = 0; i < count; i++ )
+   {
+      const int64_t ticks = m_start + static_cast<int64_t>( i ) * m_spacing;
+
+      /*
+       * nodes of the previous table on the same grid are copied
+       */
+      if ( previous != nullptr && ticks >= previous->m_start && ticks <= previous->m_end )
+      {
+         const size_t j = static_cast<size_t>( ( ticks - previous->m_start ) / m_spacing );
+         m_positions.push_back( previous->m_positions[j] );
+         m_rates.push_back( previous->m_rates[j] );
+         continue;
+      }
+
+      const DateTime dt( ticks );
+      const Vector before = solar_position.FindPosition(
+                               dt.AddSeconds( -kRateStepSeconds ) ).Position();
+      const Vector after = solar_position.FindPosition(
+                              dt.AddSeconds( kRateStepSeconds ) ).Position();
+
+      m_positions.push_back( solar_position.FindPosition( dt ).Position() );
+      m_rates.push_back( Vector( ( after.x - before.x ) * scale,
+                                 ( after.y - before.y ) * scale,
+                                 ( after.z - before.z ) * scale,
+                                 ( after.w - before.w ) * scale ) );
+   }
+}
+
+Eci SolarEphemeris::FindPosition( const DateTime& dt ) const
+{
+   if ( !Covers( dt ) )
+   {
+      SolarPosition solar_position;
+      return solar_position.FindPosition( dt );
+   }
+
+   if ( m_positions.size() == 1 )
+   {
+      return Eci( dt, m_positions[0] );
+   }
+
+   const int64_t offset = dt.Ticks() - m_start;
+   size_t i = static_cast<size_t>( offset / m_spacing );
+   if ( i >= m_positions.size() - 1 )
+   {
+      i = m_positions.size() - 2;
+   }
+
+   /*
+    * cubic Hermite basis over the interval, with s in [0, 1]
+    */
+   const double s = static_cast<double>( offset - static_cast<int64_t>( i ) * m_spacing )
+                    / static_cast<double>( m_spacing );
+   const double s2 = s * s;
+   const double s3 = s2 * s;
+   const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+   const double h10 = s3 - 2.0 * s2 + s;
+   const double h01 = -2.0 * s3 + 3.0 * s2;
+   const double h11 = s3 - s2;
+
+   const Vector& p0 = m_positions[i];
+   const Vector& p1 = m_positions[i + 1];
+   const Vector& m0 = m_rates[i];
+   const Vector& m1 = m_rates[i + 1];
+
+   return Eci( dt, Vector( h00 * p0.x + h10 * m0.x + h01 * p1.x + h11 * m1.x,
+                           h00 * p0.y + h10 * m0.y + h01 * p1.y + h11 * m1.y,
+                           h00 * p0.z + h10 * m0.z + h01 * p1.z + h11 * m1.z,
+                           h00 * p0.w + h10 * m0.w + h01 * p1.w + h11 * m1.w ) );
+}
+
+std::shared_ptr<const SolarEphemeris> SolarEphemeris::Shared(
+   const DateTime& start,
+   const DateTime& end )
+{
+   static std::mutex mutex;
+   static std::shared_ptr<const SolarEphemeris> shared;
+
+   std::lock_guard<std::mutex> lock( mutex );
+
+   if ( shared && shared->Covers( start ) && shared->Covers( end ) )
+   {
+      return shared;
+   }
+
+   /*
+    * add a day of margin, so windows that creep forward in time do not
+    * rebuild the table on every request
+    */
+   const int64_t new_start = start.Ticks() - TicksPerDay;
+   int64_t new_end = end.Ticks() + TicksPerDay;
+   if ( !shared )
+   {
+      shared = std::make_shared<const SolarEphemeris>( DateTime( new_start ),
+               DateTime( new_end ) );
+      return shared;
+   }
+
+   /*
+    * nodes before the request are dropped, so the table of a long running
+    * caller does not grow without bound; the first node stays on the grid
+    * of the old table so the nodes they share are copied rather than
+    * evaluated again. Callers still holding the old table keep it alive.
+    */
+   const int64_t offset = new_start - shared->m_start;
+   int64_t nodes = offset / shared->m_spacing;
+   if ( offset % shared->m_spacing < 0 )
+   {
+      nodes--;
+   }
+   if ( new_end >= shared->m_start )
+   {
+      new_end = std::max( new_end, shared->m_end );
+   }
+   shared = std::shared_ptr<const SolarEphemeris>( new SolarEphemeris(
+               shared->m_start + nodes * shared->m_spacing, new_end, *shared ) );
+   return shared;
+}
+
+} // namespace libsgp4
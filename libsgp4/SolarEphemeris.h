@@ -0,0 +1,113 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "DateTime.h"
+#include "Eci.h"
+#include "TimeSpan.h"
+#include "Vector.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief A table of solar positions with cubic Hermite interpolation.
+ *
+ * SolarPosition is evaluated at each node of the table, and at one minute
+ * either side for the rates, when the table is built. Lookups then cost a
+ * handful of multiplications. With the default one hour spacing the
+ * interpolation error is a few metres, far below the accuracy of the
+ * SolarPosition series itself.
+ *
+ * A table is immutable once built, so lookups are thread-safe.
+ */
+class SolarEphemeris
+{
+public:
+   /**
+    * Constructor
+    * @param[in] start start of the span to tabulate
+    * @param[in] end end of the span to tabulate
+    * @param[in] spacing spacing of the table nodes
+    */
+   SolarEphemeris( const DateTime& start,
+                   const DateTime& end,
+                   const TimeSpan& spacing = TimeSpan( 1, 0, 0 ) );
+
+   /**
+    * @param[in] dt the time to check
+    * @returns whether dt is within the tabulated span
+    */
+   bool Covers( const DateTime& dt ) const
+   {
+      return dt.Ticks() >= m_start && dt.Ticks() <= m_end;
+   }
+
+   /**
+    * Find the position of the Sun. Times outside the tabulated span are
+    * evaluated with SolarPosition directly.
+    * @param[in] dt the time
+    * @returns the position of the Sun in km
+    */
+   Eci FindPosition( const DateTime& dt ) const;
+
+   /**
+    * Get a table shared by all callers that covers at least the given span.
+    * When the shared table does not cover the request it is replaced by one
+    * from a day before the start, so it does not grow without bound; the
+    * nodes the two tables share are copied rather than evaluated again.
+    * @param[in] start start of the span needed
+    * @param[in] end end of the span needed
+    * @returns the shared table
+    */
+   static std::shared_ptr<const SolarEphemeris> Shared( const DateTime& start,
+         const DateTime& end );
+
+private:
+   /**
+    * Constructor for Shared, copying the nodes it shares with previous
+    * @param[in] start ticks of the first node, on the grid of previous
+    * @param[in] end ticks of the end of the span to tabulate
+    * @param[in] previous the table being replaced
+    */
+   SolarEphemeris( int64_t start, int64_t end, const SolarEphemeris& previous );
+
+   /**
+    * Fill in the nodes from m_start to end, copying those of previous
+    * @param[in] end ticks of the end of the span to tabulate
+    * @param[in] previous a table with the same spacing, or nullptr
+    */
+   void Build( int64_t end, const SolarEphemeris* previous );
+
+   /** ticks of the first node */
+   int64_t m_start;
+   /** ticks of the last node */
+   int64_t m_end;
+   /** ticks between nodes */
+   int64_t m_spacing;
+   /** position at each node */
+   std::vector<Vector> m_positions;
+   /** rate of change per node spacing at each node */
+   std::vector<Vector> m_rates;
+};
+
+} // namespace libsgp4
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Lock-free ring buffer for one producer thread and one consumer
+ * thread.
+ *
+ * Neither side ever blocks: TryPush fails when the buffer is full and
+ * TryPop fails when it is empty.
+ */
+template
+<typename T>
+class SpscRingBuffer
+{
+public:
+   /**
+    * Constructor
+    * @param[in] capacity minimum number of elements, rounded up to a power
+    * of two
+    */
+   explicit SpscRingBuffer( size_t capacity )
+   {
+      size_t size = 1;
+      while ( size < capacity )
+      {
+         size <<= 1;
+      }
+      m_buffer.resize( size );
+      m_mask = size - 1;
+   }
+
+   SpscRingBuffer( const SpscRingBuffer& ) = delete;
+   SpscRingBuffer& operator=( const SpscRingBuffer& ) = delete;
+
+   /**
+    * Add an element, producer thread only
+    * @param[in] value the element to add
+    * @returns false if the buffer is full
+    */
+   bool TryPush( const T& value )
+   {
+      const size_t tail = m_tail.load( std::memory_order_relaxed );
+      if ( tail - m_head.load( std::memory_order_acquire ) > m_mask )
+      {
+         return false;
+      }
+      m_buffer[tail & m_mask] = value;
+      m_tail.store( tail + 1, std::memory_order_release );
+      return true;
+   }
+
+   /**
+    * Remove the oldest element, consumer thread only
+    * @param[out] value the element removed
+    * @returns false if the buffer is empty
+    */
+   bool TryPop( T& value )
+   {
+      const size_t head = m_head.load( std::memory_order_relaxed );
+      if ( head == m_tail.load( std::memory_order_acquire ) )
+      {
+         return false;
+      }
+      value = m_buffer[head & m_mask];
+      m_head.store( head + 1, std::memory_order_release );
+      return true;
+   }
+
+   /**
+    * @returns the number of elements buffered, exact only when called from
+    * the producer or consumer thread while the other side is idle
+    */
+   size_t Size() const
+   {
+      return m_tail.load( std::memory_order_acquire )
+             - m_head.load( std::memory_order_acquire );
+   }
+
+   /**
+    * @returns the number of elements the buffer can hold
+    */
+   size_t Capacity() const
+   {
+      return m_mask + 1;
+   }
+
+private:
+   std::vector<T> m_buffer;
+   size_t m_mask{};
+   /** next element to pop, written by the consumer */
+   alignas( 64 ) std::atomic<size_t> m_head{ 0 };
+   /** next element to push, written by the producer */
+   alignas( 64 ) std::atomic<size_t> m_tail{ 0 };
+};
+
+} // namespace libsgp4
@@ -17,6 +17,8 @@
 
 #include "Tle.h"
 
+#include "Tracing.h"
+
 #include <locale>
 
 namespace libsgp4
@@ -70,6 +72,8 @@ static const unsigned int TLE2_LEN_REVATEPOCH = 5;
  */
 void Tle::Initialize()
 {
+   SGP4_TRACE_SCOPE( "Tle::Initialize" );
+
    if ( !IsValidLineLength( line_one_ ) )
    {
       throw TleException( "Invalid length for line one" );
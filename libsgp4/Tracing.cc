@@ -0,0 +1,253 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace libsgp4
+{
+
+namespace Tracing
+{
+
+namespace
+{
+
+struct Event
+{
+   const char* name;
+   int64_t begin;
+   int64_t end;
+};
+
+/*
+ * the events of one thread; only that thread writes them, and the count is
+ * published with release ordering after each event
+ */
+struct ThreadBuffer
+{
+   explicit ThreadBuffer( const int id )
+      : tid( id )
+      , events( kCapacity )
+   {
+   }
+
+   int tid;
+   std::string name;
+   std::vector<Event> events;
+   std::atomic<uint64_t> written{ 0 };
+   /* the count when the buffer was last cleared, guarded by the registry mutex */
+   uint64_t cleared{ 0 };
+};
+
+/*
+ * buffers outlive their threads, so a trace can be written after the
+ * threads that recorded it have finished
+ */
+std::mutex g_registry_mutex;
+std::vector<std::shared_ptr<ThreadBuffer>>& Registry()
+{
+   static std::vector<std::shared_ptr<ThreadBuffer>> registry;
+   return registry;
+}
+
+/*
+ * buffers of threads that have exited, for the next threads to record into,
+ * so there are only as many buffers as threads ever traced at once
+ */
+std::vector<std::shared_ptr<ThreadBuffer>>& Idle()
+{
+   static std::vector<std::shared_ptr<ThreadBuffer>> idle;
+   return idle;
+}
+
+/*
+ * the buffer of a thread, handed back to Idle when the thread exits
+ */
+struct LocalHolder
+{
+   LocalHolder() = default;
+   LocalHolder( const LocalHolder& ) = delete;
+   LocalHolder& operator=( const LocalHolder& ) = delete;
+
+   ~LocalHolder()
+   {
+      if ( buffer )
+      {
+         std::lock_guard<std::mutex> lock( g_registry_mutex );
+         Idle().push_back( std::move( buffer ) );
+      }
+   }
+
+   std::shared_ptr<ThreadBuffer> buffer;
+};
+
+std::atomic<bool> g_enabled{ true };
+
+const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+ThreadBuffer& LocalBuffer()
+{
+   thread_local LocalHolder holder;
+   if ( !holder.buffer )
+   {
+      std::lock_guard<std::mutex> lock( g_registry_mutex );
+      if ( Idle().empty() )
+      {
+         holder.buffer = std::make_shared<ThreadBuffer>( static_cast<int>( Registry().size() ) + 1 );
+         Registry().push_back( holder.buffer );
+      }
+      else
+      {
+         /*
+          * the events of the exited thread are kept, under its tid, but not
+          * its name
+          */
+         holder.buffer = std::move( Idle().back() );
+         Idle().pop_back();
+         holder.buffer->name.clear();
+      }
+   }
+   return *holder.buffer;
+}
+
+void WriteString( std::ostream& os, const std::string& str )
+{
+   os << '"';
+   for ( const char c : str )
+   {
+      if ( c == '"' || c == '\\' )
+      {
+         os << '\\';
+      }
+      os << c;
+   }
+   os << '"';
+}
+
+} // namespace
+
+void SetEnabled( const bool enabled )
+{
+   g_enabled.store( enabled, std::memory_order_relaxed );
+}
+
+bool Enabled()
+{
+   return g_enabled.load( std::memory_order_relaxed );
+}
+
+void SetThreadName( const std::string& name )
+{
+   ThreadBuffer& buffer = LocalBuffer();
+   std::lock_guard<std::mutex> lock( g_registry_mutex );
+   buffer.name = name;
+}
+
+int64_t Now()
+{
+   return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - g_epoch ).count();
+}
+
+void Record( const char* name, const int64_t begin, const int64_t end )
+{
+   ThreadBuffer& buffer = LocalBuffer();
+   const uint64_t n = buffer.written.load( std::memory_order_relaxed );
+   buffer.events[n & ( kCapacity - 1 )] = { name, begin, end };
+   buffer.written.store( n + 1, std::memory_order_release );
+}
+
+void WriteChromeTrace( std::ostream& os )
+{
+   std::lock_guard<std::mutex> lock( g_registry_mutex );
+
+   const std::ios::fmtflags flags = os.flags();
+   const std::streamsize precision = os.precision();
+   os << std::fixed << std::setprecision( 3 );
+
+   os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+   bool first = true;
+   for ( const auto& buffer : Registry() )
+   {
+      if ( !buffer->name.empty() )
+      {
+         os << ( first ? "\n" : ",\n" );
+         os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << buffer->tid << ",\"args\":{\"name\":";
+         WriteString( os, buffer->name );
+         os << "}}";
+         first = false;
+      }
+
+      const uint64_t written = buffer->written.load( std::memory_order_acquire );
+      const uint64_t start = std::max( buffer->cleared,
+                                       written > kCapacity ? written - kCapacity : 0 );
+      for ( uint64_t i = start; i < written; i++ )
+      {
+         const Event& event = buffer->events[i & ( kCapacity - 1 )];
+         os << ( first ? "\n" : ",\n" );
+         os << "{\"name\":";
+         WriteString( os, event.name );
+         os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+            << ",\"ts\":" << static_cast<double>( event.begin ) / 1e3
+            << ",\"dur\":" << static_cast<double>( event.end - event.begin ) / 1e3
+            << "}";
+         first = false;
+      }
+   }
+   os << "\n]}\n";
+
+   os.flags( flags );
+   os.precision( precision );
+}
+
+bool WriteChromeTrace( const std::string& filename )
+{
+   std::ofstream os( filename );
+   if ( !os.is_open() )
+   {
+      return false;
+   }
+   WriteChromeTrace( os );
+   return static_cast<bool>( os );
+}
+
+void Clear()
+{
+   /*
+    * only the owning thread writes the count; the spans before it are
+    * skipped when writing instead
+    */
+   std::lock_guard<std::mutex> lock( g_registry_mutex );
+   for ( const auto& buffer : Registry() )
+   {
+      buffer->cleared = buffer->written.load( std::memory_order_acquire );
+   }
+}
+
+} // namespace Tracing
+
+} // namespace libsgp4
@@ -0,0 +1,153 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Optional scoped tracing spans, exported as Chrome trace events.
+ *
+ * Spans exist when the library is built with SGP4_TRACING defined (the
+ * CMake option of the same name); otherwise SGP4_TRACE_SCOPE compiles to
+ * nothing and the exported trace is empty.
+ *
+ * A span records its begin and end times when it leaves scope, as one
+ * event in a ring buffer owned by the calling thread, so recording takes
+ * no locks. Each buffer keeps the most recent kCapacity events. When a
+ * thread exits its buffer, with its events, passes to the next thread that
+ * records a span, so a process holds one buffer per thread tracing at once
+ * rather than per thread it ever started. The trace can be written at any
+ * time, but spans recorded while it is being written may be missed or,
+ * once their buffer wraps, overwritten; export once the traced threads
+ * are idle.
+ *
+ * The output loads in chrome://tracing or https://ui.perfetto.dev.
+ */
+namespace Tracing
+{
+
+#ifdef SGP4_TRACING
+const bool kEnabled = true;
+#else
+const bool kEnabled = false;
+#endif
+
+/** events kept per thread */
+const uint64_t kCapacity = 1 << 15;
+
+/**
+ * Pause or resume recording, for all threads. Recording starts enabled.
+ * @param[in] enabled whether spans are recorded
+ */
+void SetEnabled( const bool enabled );
+
+/**
+ * @returns whether spans are recorded
+ */
+bool Enabled();
+
+/**
+ * Name the calling thread in the trace
+ * @param[in] name the thread name
+ */
+void SetThreadName( const std::string& name );
+
+/**
+ * @returns nanoseconds since the start of the trace
+ */
+int64_t Now();
+
+/**
+ * Record a span on the calling thread
+ * @param[in] name the span name, which must outlive the trace
+ * @param[in] begin start of the span from Now()
+ * @param[in] end end of the span from Now()
+ */
+void Record( const char* name, const int64_t begin, const int64_t end );
+
+/**
+ * Write the recorded spans of all threads in Chrome trace event format
+ * @param[in] os the stream to write to
+ */
+void WriteChromeTrace( std::ostream& os );
+
+/**
+ * Write the recorded spans of all threads to a file in Chrome trace event
+ * format
+ * @param[in] filename the file to write
+ * @returns false if the file could not be written
+ */
+bool WriteChromeTrace( const std::string& filename );
+
+/**
+ * Discard the spans recorded so far by all threads. Spans recorded while
+ * clearing may be kept or discarded.
+ */
+void Clear();
+
+/**
+ * @brief Records a span from its construction to its destruction.
+ */
+class Span
+{
+public:
+   /**
+    * Constructor
+    * @param[in] name the span name, which must outlive the trace
+    */
+   explicit Span( const char* name )
+      : m_name( name )
+      , m_begin( Enabled() ? Now() : -1 )
+   {
+   }
+
+   ~Span()
+   {
+      if ( m_begin >= 0 )
+      {
+         Record( m_name, m_begin, Now() );
+      }
+   }
+
+   Span( const Span& ) = delete;
+   Span& operator=( const Span& ) = delete;
+
+private:
+   /** the span name */
+   const char* m_name;
+   /** start of the span, negative when not recording */
+   int64_t m_begin;
+};
+
+} // namespace Tracing
+
+} // namespace libsgp4
+
+#ifdef SGP4_TRACING
+#define SGP4_TRACE_CONCAT_( a, b ) a##b
+#define SGP4_TRACE_CONCAT( a, b ) SGP4_TRACE_CONCAT_( a, b )
+#define SGP4_TRACE_SCOPE( name ) \
+   ::libsgp4::Tracing::Span SGP4_TRACE_CONCAT( sgp4_trace_span_, __LINE__ )( name )
+#else
+#define SGP4_TRACE_SCOPE( name ) ( ( void ) 0 )
+#endif
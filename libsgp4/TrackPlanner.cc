@@ -0,0 +1,198 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "TrackPlanner.h"
+
+#include "Globals.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * Convert a command from azimuth / elevation to X-Y axis angles, with X
+ * about the north-south axis (positive towards east) and Y the tilt towards
+ * north.
+ */
+void ToXY( PointingCommand& command )
+{
+   const double sin_az = std::sin( command.azimuth );
+   const double cos_az = std::cos( command.azimuth );
+   const double sin_el = std::sin( command.elevation );
+   const double cos_el = std::cos( command.elevation );
+
+   const double east = cos_el * sin_az;
+   const double north = cos_el * cos_az;
+   const double up = sin_el;
+
+   const double east_rate = -sin_el * sin_az * command.elevation_rate
+                            + cos_el * cos_az * command.azimuth_rate;
+   const double north_rate = -sin_el * cos_az * command.elevation_rate
+                             - cos_el * sin_az * command.azimuth_rate;
+   const double up_rate = cos_el * command.elevation_rate;
+
+   const double xz2 = east * east + up * up;
+
+   command.azimuth = std::atan2( east, up );
+   command.elevation = std::asin( std::max( -1.0, std::min( 1.0, north ) ) );
+   command.azimuth_rate = xz2 > 0.0 ? ( up * east_rate - east * up_rate ) / xz2 : 0.0;
+   command.elevation_rate = xz2 > 0.0 ? north_rate / std::sqrt( xz2 ) : 0.0;
+}
+}
+
+TrackPlan TrackPlanner::Plan( std::vector<PointingCommand>& commands,
+                              const double current_azimuth ) const
+{
+   TrackPlan plan;
+
+   if ( commands.empty() )
+   {
+      plan.within_limits = true;
+      return plan;
+   }
+
+   /*
+    * analysis sweep: the extent of the unwrapped azimuth and the peaks that
+    * identify a keyhole pass, together with the largest azimuth step, which
+    * is where the pass goes by the zenith, and the extents before and from
+    * that step
+    */
+   const double first = commands.front().azimuth;
+   double plain = first;
+   double plain_min = first;
+   double plain_max = first;
+   double largest_step = 0.0;
+   size_t zenith = 0;
+   double before_min = first;
+   double before_max = first;
+   double after_min = first;
+   double after_max = first;
+
+   for ( size_t i = 0; i < commands.size(); i++ )
+   {
+      const PointingCommand& command = commands[i];
+      plan.peak_elevation = std::max( plan.peak_elevation, command.elevation );
+      plan.peak_azimuth_rate = std::max( plan.peak_azimuth_rate,
+                                         std::fabs( command.azimuth_rate ) );
+
+      const double step = Util::WrapNegPosPI( command.azimuth - plain );
+      if ( std::fabs( step ) > std::fabs( largest_step ) )
+      {
+         largest_step = step;
+         zenith = i;
+         before_min = plain_min;
+         before_max = plain_max;
+         after_min = plain + step;
+         after_max = plain + step;
+      }
+      plain += step;
+      plain_min = std::min( plain_min, plain );
+      plain_max = std::max( plain_max, plain );
+      after_min = std::min( after_min, plain );
+      after_max = std::max( after_max, plain );
+   }
+
+   /*
+    * the flipped plan goes over the top: from the zenith step on the
+    * commands are (az + pi, pi - el), which turns that step of |s| into
+    * one of pi - |s|. The flip is only made where it keeps the sweep
+    * continuous, that is where both the azimuth and the elevation steps
+    * across the switch are smaller than the azimuth step it replaces.
+    */
+   bool flip_continuous = false;
+   if ( zenith > 0 && std::fabs( largest_step ) > kPI / 2.0 )
+   {
+      const double azimuth_jump = kPI - std::fabs( largest_step );
+      const double elevation_jump = std::fabs( kPI - commands[zenith].elevation
+                                    - commands[zenith - 1].elevation );
+      flip_continuous = std::max( azimuth_jump, elevation_jump ) < std::fabs( largest_step );
+   }
+   const double flip_offset = largest_step > 0.0 ? -kPI : kPI;
+   const double flip_min = std::min( before_min, after_min + flip_offset );
+   const double flip_max = std::max( before_max, after_max + flip_offset );
+
+   plan.keyhole = plan.peak_elevation >= m_limits.keyhole_elevation
+                  || plan.peak_azimuth_rate > m_limits.max_azimuth_rate;
+
+   if ( m_limits.type == MountType::X_Y )
+   {
+      plan.xy = true;
+      plan.within_limits = true;
+      for ( PointingCommand& command : commands )
+      {
+         ToXY( command );
+         if ( command.azimuth < m_limits.x_min || command.azimuth > m_limits.x_max
+               || command.elevation < m_limits.y_min || command.elevation > m_limits.y_max )
+         {
+            plan.within_limits = false;
+         }
+      }
+      return plan;
+   }
+
+   const bool use_flip = plan.keyhole && flip_continuous
+                         && m_limits.type == MountType::AZ_EL_FLIP;
+   const double low = use_flip ? flip_min : plain_min;
+   const double high = use_flip ? flip_max : plain_max;
+
+   /*
+    * choose the turn of the cable wrap: the one nearest the current azimuth
+    * among those that hold the whole pass, else the one centring the pass
+    */
+   const double k_low = std::ceil( ( m_limits.azimuth_min - low ) / kTWOPI );
+   const double k_high = std::floor( ( m_limits.azimuth_max - high ) / kTWOPI );
+   double turns;
+   if ( k_low <= k_high )
+   {
+      plan.within_limits = true;
+      turns = std::min( k_high, std::max( k_low,
+                                           std::round( ( current_azimuth - first ) / kTWOPI ) ) );
+   }
+   else
+   {
+      plan.within_limits = false;
+      turns = std::round( ( ( m_limits.azimuth_min + m_limits.azimuth_max )
+                            - ( low + high ) ) / ( 2.0 * kTWOPI ) );
+   }
+   const double shift = turns * kTWOPI;
+
+   /*
+    * rewrite sweep, repeating the unwrapping of the analysis
+    */
+   double unwrapped = first;
+   for ( size_t i = 0; i < commands.size(); i++ )
+   {
+      PointingCommand& command = commands[i];
+      if ( use_flip && i >= zenith )
+      {
+         command.azimuth += kPI;
+         command.elevation = kPI - command.elevation;
+         command.elevation_rate = -command.elevation_rate;
+         plan.flipped = true;
+      }
+      unwrapped += Util::WrapNegPosPI( command.azimuth - unwrapped );
+      command.azimuth = unwrapped + shift;
+   }
+
+   return plan;
+}
+
+} // namespace libsgp4
@@ -0,0 +1,135 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "PointingCommand.h"
+#include "Util.h"
+
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief The axes of an antenna mount.
+ */
+enum class MountType
+{
+   /** azimuth over elevation, elevation limited to [0, pi/2] */
+   AZ_EL,
+   /** azimuth over elevation, elevation can travel over the top to pi */
+   AZ_EL_FLIP,
+   /** X over Y, with the X axis horizontal and pointing north-south */
+   X_Y
+};
+
+/**
+ * @brief The limits of an antenna mount. Angles are in radians and rates in
+ * radians per second.
+ */
+struct MountLimits
+{
+   MountType type{ MountType::AZ_EL };
+   /** lower limit of the azimuth cable wrap */
+   double azimuth_min{ Util::DegreesToRadians( -270.0 ) };
+   /** upper limit of the azimuth cable wrap */
+   double azimuth_max{ Util::DegreesToRadians( 270.0 ) };
+   /** passes culminating above this elevation are keyhole passes */
+   double keyhole_elevation{ Util::DegreesToRadians( 85.0 ) };
+   /** passes needing a faster azimuth rate are keyhole passes */
+   double max_azimuth_rate{ Util::DegreesToRadians( 10.0 ) };
+   /** lower limit of the X axis of an X-Y mount; the X-Y limits default to
+    * the whole sky, with a degree to spare for the samples at rise and set,
+    * which can fall just below the horizon */
+   double x_min{ Util::DegreesToRadians( -91.0 ) };
+   /** upper limit of the X axis of an X-Y mount */
+   double x_max{ Util::DegreesToRadians( 91.0 ) };
+   /** lower limit of the Y axis of an X-Y mount */
+   double y_min{ Util::DegreesToRadians( -91.0 ) };
+   /** upper limit of the Y axis of an X-Y mount */
+   double y_max{ Util::DegreesToRadians( 91.0 ) };
+};
+
+/**
+ * @brief Summary of a planned track.
+ */
+struct TrackPlan
+{
+   /** the pass culminates above the keyhole elevation or needs an azimuth
+    * rate beyond the limit of an az-el mount */
+   bool keyhole{};
+   /** the pass goes over the top: the commands from where it passes by
+    * the zenith use the flipped elevation plan */
+   bool flipped{};
+   /** the commands are X-Y axis angles */
+   bool xy{};
+   /** the azimuth stays within the cable wrap, or the X-Y axis angles
+    * within their limits, for the whole pass */
+   bool within_limits{};
+   /** peak elevation of the pass in radians */
+   double peak_elevation{};
+   /** peak azimuth rate of the pass in radians per second */
+   double peak_azimuth_rate{};
+};
+
+/**
+ * @brief Turns the look angles of a pass into commands a mount can follow.
+ *
+ * For az-el mounts the azimuth is unwrapped and placed within the cable
+ * wrap, choosing the wrap closest to the current antenna azimuth. On a
+ * mount that can flip, a keyhole pass whose azimuth steps by more than a
+ * quarter turn between two samples, as it goes by the zenith, is commanded
+ * as (az + pi, pi - el) from that step on, so the antenna goes over the
+ * top instead of slewing round through half a turn. The switch is made
+ * once per pass, and only when the flipped commands are continuous across
+ * it; a pass that misses the zenith by more than the sampling resolves is
+ * commanded without the flip. For X-Y mounts the commands are converted to
+ * axis angles, stored in the azimuth (X) and elevation (Y) fields, and
+ * checked against the axis limits.
+ *
+ * The samples are analysed in one sweep and rewritten in a second, with
+ * no per-sample trigonometry outside the X-Y conversion.
+ */
+class TrackPlanner
+{
+public:
+   /**
+    * Constructor
+    * @param[in] limits the limits of the mount
+    */
+   explicit TrackPlanner( const MountLimits& limits )
+      : m_limits( limits )
+   {
+   }
+
+   /**
+    * Plan a track in place
+    * @param[in,out] commands the look angles of one pass in time order,
+    * sampled finely enough that the azimuth moves less than pi between
+    * samples; replaced by the mount commands
+    * @param[in] current_azimuth the current unwrapped antenna azimuth
+    * @returns the summary of the plan
+    */
+   TrackPlan Plan( std::vector<PointingCommand>& commands,
+                   const double current_azimuth = 0.0 ) const;
+
+private:
+   MountLimits m_limits;
+};
+
+} // namespace libsgp4
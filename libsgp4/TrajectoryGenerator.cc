@@ -0,0 +1,264 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "TrajectoryGenerator.h"
+
+#include "CoordTopocentric.h"
+#include "Eci.h"
+#include "Tracing.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace libsgp4
+{
+
+namespace
+{
+/*
+ * half width in seconds of the central difference used for the node rates
+ */
+const double kRateStepSeconds = 0.5;
+
+/*
+ * push a command, yielding while the ring is full; false if stop was set
+ * first
+ */
+bool Push( const PointingCommand& command,
+           SpscRingBuffer<PointingCommand>& ring,
+           const std::atomic<bool>& stop )
+{
+   while ( !ring.TryPush( command ) )
+   {
+      if ( stop.load( std::memory_order_relaxed ) )
+      {
+         return false;
+      }
+      std::this_thread::yield();
+   }
+   return true;
+}
+}
+
+PropagationStatus TrajectoryGenerator::Prepare( const DateTime& start,
+      const DateTime& end,
+      const int coarse_step )
+{
+   SGP4_TRACE_SCOPE( "TrajectoryGenerator::Prepare" );
+
+   m_start = start.Ticks();
+   m_end = std::max( end.Ticks(), m_start );
+   m_step = std::max<int64_t>( coarse_step, 1 ) * TicksPerSecond;
+
+   const int64_t intervals = ( m_end - m_start + m_step - 1 ) / m_step;
+   m_nodes.clear();
+   m_nodes.reserve( static_cast<size_t>( intervals ) + 1 );
+
+   for ( int64_t i = 0; i <= intervals; i++ )
+   {
+      Node node;
+      const PropagationStatus status = Evaluate( DateTime( m_start + i * m_step ), node );
+      if ( status != PropagationStatus::OK )
+      {
+         m_nodes.clear();
+         return status;
+      }
+
+      /*
+       * unwrap against the previous node so segments never cross the
+       * 0 / 2pi boundary
+       */
+      if ( !m_nodes.empty() )
+      {
+         const double previous = m_nodes.back().azimuth;
+         node.azimuth = previous + Util::WrapNegPosPI( node.azimuth - previous );
+      }
+      m_nodes.push_back( node );
+   }
+   return PropagationStatus::OK;
+}
+
+PropagationStatus TrajectoryGenerator::Evaluate( const DateTime& dt, Node& node )
+{
+   Eci eci( dt, Vector() );
+   const PropagationStatus status = m_sgp4.Propagate( dt, eci );
+   if ( status != PropagationStatus::OK )
+   {
+      return status;
+   }
+   const Vector position = eci.Position();
+   const Vector velocity = eci.Velocity();
+
+   /*
+    * the rates come from look angles either side of the node, with the
+    * satellite moved along its velocity rather than propagated again
+    */
+   const Vector offset( velocity.x * kRateStepSeconds,
+                        velocity.y * kRateStepSeconds,
+                        velocity.z * kRateStepSeconds );
+   const Eci before( dt.AddSeconds( -kRateStepSeconds ),
+                     Vector( position.x - offset.x,
+                             position.y - offset.y,
+                             position.z - offset.z ),
+                     velocity );
+   const Eci after( dt.AddSeconds( kRateStepSeconds ),
+                    Vector( position.x + offset.x,
+                            position.y + offset.y,
+                            position.z + offset.z ),
+                    velocity );
+
+   const CoordTopocentric topo = m_observer.GetLookAngle( eci );
+   const CoordTopocentric topo_before = m_observer.GetLookAngle( before );
+   const CoordTopocentric topo_after = m_observer.GetLookAngle( after );
+
+   node.azimuth = topo.m_azimuth;
+   node.elevation = topo.m_elevation;
+   node.azimuth_rate = Util::WrapNegPosPI( topo_after.m_azimuth - topo_before.m_azimuth )
+                       / ( 2.0 * kRateStepSeconds );
+   node.elevation_rate = ( topo_after.m_elevation - topo_before.m_elevation )
+                         / ( 2.0 * kRateStepSeconds );
+   return PropagationStatus::OK;
+}
+
+PointingCommand TrajectoryGenerator::Interpolate( const int64_t ticks ) const
+{
+   PointingCommand command{};
+   command.ticks = ticks;
+
+   if ( m_nodes.empty() )
+   {
+      return command;
+   }
+
+   const int64_t offset = std::min( std::max( ticks, m_start ), m_end ) - m_start;
+   size_t i = static_cast<size_t>( offset / m_step );
+   if ( m_nodes.size() == 1 )
+   {
+      const Node& node = m_nodes.front();
+      command.azimuth = Util::WrapTwoPI( node.azimuth );
+      command.elevation = node.elevation;
+      command.azimuth_rate = node.azimuth_rate;
+      command.elevation_rate = node.elevation_rate;
+      return command;
+   }
+   if ( i >= m_nodes.size() - 1 )
+   {
+      i = m_nodes.size() - 2;
+   }
+
+   /*
+    * cubic Hermite basis over the segment, with s in [0, 1], and its
+    * derivative for the rates
+    */
+   const double h = static_cast<double>( m_step ) / TicksPerSecond;
+   const double s = static_cast<double>( offset - static_cast<int64_t>( i ) * m_step )
+                    / static_cast<double>( m_step );
+   const double s2 = s * s;
+   const double s3 = s2 * s;
+   const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+   const double h10 = s3 - 2.0 * s2 + s;
+   const double h01 = -2.0 * s3 + 3.0 * s2;
+   const double h11 = s3 - s2;
+   const double d00 = 6.0 * s2 - 6.0 * s;
+   const double d10 = 3.0 * s2 - 4.0 * s + 1.0;
+   const double d11 = 3.0 * s2 - 2.0 * s;
+
+   const Node& n0 = m_nodes[i];
+   const Node& n1 = m_nodes[i + 1];
+
+   command.azimuth = Util::WrapTwoPI( h00 * n0.azimuth
+                                      + h10 * h * n0.azimuth_rate
+                                      + h01 * n1.azimuth
+                                      + h11 * h * n1.azimuth_rate );
+   command.elevation = h00 * n0.elevation
+                       + h10 * h * n0.elevation_rate
+                       + h01 * n1.elevation
+                       + h11 * h * n1.elevation_rate;
+   command.azimuth_rate = d00 * ( n0.azimuth - n1.azimuth ) / h
+                          + d10 * n0.azimuth_rate
+                          + d11 * n1.azimuth_rate;
+   command.elevation_rate = d00 * ( n0.elevation - n1.elevation ) / h
+                            + d10 * n0.elevation_rate
+                            + d11 * n1.elevation_rate;
+   return command;
+}
+
+void TrajectoryGenerator::Generate( const double rate,
+                                    std::vector<PointingCommand>& commands ) const
+{
+   commands.clear();
+   if ( m_nodes.empty() || rate <= 0.0 )
+   {
+      return;
+   }
+
+   const double interval = TicksPerSecond / rate;
+   const size_t count = static_cast<size_t>(
+                           static_cast<double>( m_end - m_start ) / interval ) + 1;
+   commands.reserve( count );
+   for ( size_t i = 0; i < count; i++ )
+   {
+      commands.push_back( Interpolate( m_start + static_cast<int64_t>(
+                                          std::llround( static_cast<double>( i ) * interval ) ) ) );
+   }
+}
+
+size_t TrajectoryGenerator::Produce( const double rate,
+                                     SpscRingBuffer<PointingCommand>& ring,
+                                     const std::atomic<bool>& stop ) const
+{
+   if ( m_nodes.empty() || rate <= 0.0 )
+   {
+      return 0;
+   }
+
+   const double interval = TicksPerSecond / rate;
+   const size_t count = static_cast<size_t>(
+                           static_cast<double>( m_end - m_start ) / interval ) + 1;
+   size_t pushed = 0;
+   while ( pushed < count )
+   {
+      const PointingCommand command = Interpolate( m_start + static_cast<int64_t>(
+                                         std::llround( static_cast<double>( pushed ) * interval ) ) );
+      if ( !Push( command, ring, stop ) )
+      {
+         return pushed;
+      }
+      pushed++;
+   }
+   return pushed;
+}
+
+size_t TrajectoryGenerator::Produce( const std::vector<PointingCommand>& commands,
+                                     SpscRingBuffer<PointingCommand>& ring,
+                                     const std::atomic<bool>& stop )
+{
+   size_t pushed = 0;
+   for ( const PointingCommand& command : commands )
+   {
+      if ( !Push( command, ring, stop ) )
+      {
+         break;
+      }
+      pushed++;
+   }
+   return pushed;
+}
+
+} // namespace libsgp4
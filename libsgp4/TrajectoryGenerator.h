@@ -0,0 +1,162 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "CoordGeodetic.h"
+#include "DateTime.h"
+#include "Observer.h"
+#include "PointingCommand.h"
+#include "PropagationStatus.h"
+#include "SGP4.h"
+#include "SpscRingBuffer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace libsgp4
+{
+
+/**
+ * @brief Generates antenna pointing commands for a span of time, usually a
+ * pass.
+ *
+ * The satellite is propagated once per coarse step when the span is
+ * prepared. Commands at the output rate are then interpolated from those
+ * nodes with cubic Hermite segments, so producing them involves no further
+ * propagation. The azimuth is unwrapped across the nodes before
+ * interpolating and wrapped back to [0, 2pi) in the commands.
+ */
+class TrajectoryGenerator
+{
+public:
+   /**
+    * Constructor
+    * @param[in] geo the observers position
+    * @param[in] sgp4 the propagator for the satellite, must outlive this object
+    */
+   TrajectoryGenerator( const CoordGeodetic& geo, const SGP4& sgp4 )
+      : m_sgp4( sgp4 )
+      , m_observer( geo )
+   {
+   }
+
+   /**
+    * Select a refraction model, so the commands point at the apparent
+    * elevation. Takes effect from the next Prepare.
+    * @param[in] model the model, must outlive this object, or nullptr for
+    * geometric elevations
+    */
+   void SetRefraction( const RefractionModel* model )
+   {
+      m_observer.SetRefraction( model );
+   }
+
+   /**
+    * Propagate the coarse nodes for a span, replacing any previous span
+    * @param[in] start start of the span
+    * @param[in] end end of the span
+    * @param[in] coarse_step seconds between nodes
+    * @returns OK, or the status of the first node that could not be
+    * propagated, in which case the span is left empty
+    */
+   PropagationStatus Prepare( const DateTime& start,
+                              const DateTime& end,
+                              const int coarse_step = 10 );
+
+   /**
+    * @param[in] dt the time to check
+    * @returns whether dt is within the prepared span
+    */
+   bool Covers( const DateTime& dt ) const
+   {
+      return !m_nodes.empty() && dt.Ticks() >= m_start && dt.Ticks() <= m_end;
+   }
+
+   /**
+    * Interpolate the command for a time, clamped to the prepared span
+    * @param[in] ticks the time of the command
+    * @returns the command
+    */
+   PointingCommand Interpolate( const int64_t ticks ) const;
+
+   /**
+    * Generate the commands for the whole prepared span
+    * @param[in] rate commands per second
+    * @param[out] commands receives the commands, in time order
+    */
+   void Generate( const double rate,
+                  std::vector<PointingCommand>& commands ) const;
+
+   /**
+    * Feed the commands for the whole prepared span into a ring buffer. Meant
+    * to run on a producer thread: it yields while the buffer is full, so the
+    * consumer only ever pops commands that are ready.
+    * @param[in] rate commands per second
+    * @param[in] ring the buffer to feed
+    * @param[in] stop set by another thread to abandon the span
+    * @returns the number of commands pushed
+    */
+   size_t Produce( const double rate,
+                   SpscRingBuffer<PointingCommand>& ring,
+                   const std::atomic<bool>& stop ) const;
+
+   /**
+    * Feed commands generated earlier, and perhaps planned by a
+    * TrackPlanner, into a ring buffer, the same way as the other Produce
+    * @param[in] commands the commands, in time order
+    * @param[in] ring the buffer to feed
+    * @param[in] stop set by another thread to abandon the commands
+    * @returns the number of commands pushed
+    */
+   static size_t Produce( const std::vector<PointingCommand>& commands,
+                          SpscRingBuffer<PointingCommand>& ring,
+                          const std::atomic<bool>& stop );
+
+private:
+   struct Node
+   {
+      double azimuth;
+      double elevation;
+      double azimuth_rate;
+      double elevation_rate;
+   };
+
+   /**
+    * @param[in] dt the time of the node
+    * @param[out] node the look angle and rates at dt, with the azimuth in
+    * [0, 2pi), set when the status is OK
+    * @returns the propagation status
+    */
+   PropagationStatus Evaluate( const DateTime& dt, Node& node );
+
+   /** the propagator for the satellite */
+   const SGP4& m_sgp4;
+   /** the observer */
+   Observer m_observer;
+   /** ticks of the first node */
+   int64_t m_start{};
+   /** ticks of the end of the span */
+   int64_t m_end{};
+   /** ticks between nodes */
+   int64_t m_step{};
+   /** the nodes, azimuth unwrapped */
+   std::vector<Node> m_nodes;
+};
+
+} // namespace libsgp4
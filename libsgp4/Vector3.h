@@ -0,0 +1,113 @@
+/*
+ * Copyright 2025 Allan Jones
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "Vector.h"
+
+#include <cmath>
+#include <type_traits>
+
+namespace libsgp4
+{
+
+/**
+ * @brief A lean 3-vector for the batch interfaces.
+ *
+ * Unlike Vector it has no w field and no user-defined copy, so it is
+ * trivially copyable and fits in registers; the magnitude is computed only
+ * when asked for. Aligned to 32 bytes so each one fills a 256 bit lane.
+ */
+struct alignas( 32 ) Vector3
+{
+   Vector3() = default;
+
+   /**
+    * Constructor
+    * @param[in] arg_x x value
+    * @param[in] arg_y y value
+    * @param[in] arg_z z value
+    */
+   Vector3( const double arg_x,
+            const double arg_y,
+            const double arg_z )
+      : x( arg_x ), y( arg_y ), z( arg_z )
+   {
+   }
+
+   /**
+    * Constructor
+    * @param[in] v the vector to copy x, y and z from
+    */
+   explicit Vector3( const Vector& v )
+      : x( v.x ), y( v.y ), z( v.z )
+   {
+   }
+
+   /**
+    * @returns this vector as a Vector, with w zero
+    */
+   Vector ToVector() const
+   {
+      return Vector( x, y, z );
+   }
+
+   Vector3 operator+( const Vector3& v ) const
+   {
+      return Vector3( x + v.x, y + v.y, z + v.z );
+   }
+
+   Vector3 operator-( const Vector3& v ) const
+   {
+      return Vector3( x - v.x, y - v.y, z - v.z );
+   }
+
+   Vector3 operator*( const double scale ) const
+   {
+      return Vector3( x * scale, y * scale, z * scale );
+   }
+
+   /**
+    * @param[in] v the other vector
+    * @returns the dot product
+    */
+   double Dot( const Vector3& v ) const
+   {
+      return x * v.x + y * v.y + z * v.z;
+   }
+
+   /**
+    * @returns the magnitude of the vector
+    */
+   double Magnitude() const
+   {
+      return std::sqrt( Dot( *this ) );
+   }
+
+   /** x value */
+   double x{};
+   /** y value */
+   double y{};
+   /** z value */
+   double z{};
+};
+
+static_assert( std::is_trivially_copyable<Vector3>::value,
+               "Vector3 must be trivially copyable" );
+static_assert( sizeof( Vector3 ) == 32, "Vector3 must fill 32 bytes" );
+
+} // namespace libsgp4
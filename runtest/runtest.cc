@@ -21,6 +21,11 @@
 #include <CoordGeodetic.h>
 #include <CoordTopocentric.h>
 
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <list>
 #include <string>
 #include <iomanip>
@@ -29,60 +34,98 @@
 #include <vector>
 #include <cstdlib>
 
-void RunTle( libsgp4::Tle tle, double start, double end, double inc )
+namespace
+{
+/*
+ * minutes between the samples timed for throughput
+ */
+const double kThroughputStep = 10.0 / 60.0;
+/*
+ * minutes between the nodes of the interpolated ephemeris
+ */
+const double kNodeStep = 1.0;
+/*
+ * bytes of a reference sample, seven doubles
+ */
+const size_t kSampleBytes = 7 * 8;
+}
+
+/*
+ * a propagated state vector; invalid when the propagation failed
+ */
+struct Sample
+{
+   double tsince;
+   libsgp4::Vector position;
+   libsgp4::Vector velocity;
+   bool valid;
+};
+
+/*
+ * the reference samples of one tle
+ */
+struct ReferenceCase
+{
+   std::string line1;
+   std::string line2;
+   std::vector<Sample> samples;
+};
+
+std::vector<Sample> RunTle( libsgp4::Tle tle,
+                            double start,
+                            double end,
+                            double inc,
+                            bool print )
 {
    double current = start;
    libsgp4::SGP4 model( tle );
    bool running = true;
    bool first_run = true;
+   std::vector<Sample> samples;
 
-   std::cout << std::setprecision( 0 ) << tle.NoradNumber() << " xx"
-             << std::endl;
+   if ( print )
+   {
+      std::cout << std::setprecision( 0 ) << tle.NoradNumber() << " xx"
+                << std::endl;
+   }
 
    while ( running )
    {
       bool error = false;
-      libsgp4::Vector position;
-      libsgp4::Vector velocity;
       double tsince;
 
-      try
+      if ( first_run && current != 0.0 )
       {
-         if ( first_run && current != 0.0 )
-         {
-            /*
-             * make sure first run is always as zero
-             */
-            tsince = 0.0;
-         }
-         else
-         {
-            /*
-             * otherwise run as normal
-             */
-            tsince = current;
-         }
-
-         libsgp4::Eci eci = model.FindPosition( tsince );
-         position = eci.Position();
-         velocity = eci.Velocity();
+         /*
+          * make sure first run is always as zero
+          */
+         tsince = 0.0;
       }
-      catch ( libsgp4::SatelliteException& e )
+      else
       {
-         std::cerr << e.what() << std::endl;
-         error = true;
-         running = false;
+         /*
+          * otherwise run as normal
+          */
+         tsince = current;
       }
-      catch ( libsgp4::DecayedException& e )
-      {
-         std::cerr << e.what() << std::endl;
 
-         position = e.Position();
-         velocity = e.Velocity();
+      libsgp4::Vector3 position;
+      libsgp4::Vector3 velocity;
+      const libsgp4::PropagationStatus status = model.Propagate( tsince, position, velocity );
 
-         if ( !first_run )
+      if ( status != libsgp4::PropagationStatus::OK )
+      {
+         if ( print )
+         {
+            std::cerr << libsgp4::ToString( status ) << std::endl;
+         }
+
+         /*
+          * a decayed satellite still has a position, which is printed on
+          * the first run
+          */
+         if ( status != libsgp4::PropagationStatus::DECAYED || !first_run )
          {
-            // print out position on first run
             error = true;
          }
 
@@ -90,6 +133,11 @@ void RunTle( libsgp4::Tle tle, double start, double end, double inc )
       }
 
       if ( !error )
+      {
+         samples.push_back( { tsince, position.ToVector(), velocity.ToVector(), true } );
+      }
+
+      if ( !error && print )
       {
          std::cout << std::setprecision( 8 ) << std::fixed;
          std::cout.width( 17 );
@@ -126,6 +174,8 @@ void RunTle( libsgp4::Tle tle, double start, double end, double inc )
       }
       first_run = false;
    }
+
+   return samples;
 }
 
 void tokenize( const std::string& str, std::vector<std::string>& tokens )
@@ -159,7 +209,11 @@ void tokenize( const std::string& str, std::vector<std::string>& tokens )
    }
 }
 
-void RunTest( const char* infile )
+/*
+ * read the test cases of a tle file, handing each to run
+ */
+bool RunTest( const char* infile,
+              const std::function<void( const libsgp4::Tle&, double, double, double )>& run )
 {
    std::ifstream file;
 
@@ -168,7 +222,7 @@ void RunTest( const char* infile )
    if ( !file.is_open() )
    {
       std::cerr << "Error opening file" << std::endl;
-      return;
+      return false;
    }
 
    bool got_first_line = false;
@@ -252,7 +306,7 @@ void RunTest( const char* infile )
             {
                //Tle::IsValidLine(line.substr(0, Tle::LineLength()), 2);
                libsgp4::Tle tle( "Test", line1, line2 );
-               RunTle( tle, start, end, inc );
+               run( tle, start, end, inc );
             }
          }
          catch ( libsgp4::TleException& e )
@@ -268,14 +322,528 @@ void RunTest( const char* infile )
     */
    file.close();
 
-   return;
+   return true;
+}
+
+
+/*
+ * little endian encoding of the reference file
+ */
+void PutDouble( char* p, const double value )
+{
+   uint64_t bits;
+   std::memcpy( &bits, &value, sizeof( bits ) );
+   for ( size_t i = 0; i < sizeof( bits ); i++ )
+   {
+      p[i] = static_cast<char>( ( bits >> ( 8 * i ) ) & 0xff );
+   }
+}
+
+double GetDouble( const char* p )
+{
+   uint64_t bits = 0;
+   for ( size_t i = 0; i < sizeof( bits ); i++ )
+   {
+      bits |= static_cast<uint64_t>( static_cast<unsigned char>( p[i] ) ) << ( 8 * i );
+   }
+   double value;
+   std::memcpy( &value, &bits, sizeof( value ) );
+   return value;
+}
+
+void PutUint32( char* p, const uint32_t value )
+{
+   for ( size_t i = 0; i < 4; i++ )
+   {
+      p[i] = static_cast<char>( ( value >> ( 8 * i ) ) & 0xff );
+   }
+}
+
+uint32_t GetUint32( const char* p )
+{
+   uint32_t value = 0;
+   for ( size_t i = 0; i < 4; i++ )
+   {
+      value |= static_cast<uint32_t>( static_cast<unsigned char>( p[i] ) ) << ( 8 * i );
+   }
+   return value;
+}
+
+/*
+ * Reference file layout, all little endian:
+ *   "SREF", uint32 case count
+ *   per case: the two tle lines (69 bytes each), uint32 sample count,
+ *   then per sample seven doubles: tsince (minutes), position (km) and
+ *   velocity (km/s)
+ */
+bool WriteReference( const char* infile, const char* outfile )
+{
+   std::vector<ReferenceCase> cases;
+   const bool read = RunTest( infile, [&cases]( const libsgp4::Tle& tle, double start, double end, double inc )
+   {
+      cases.push_back( { tle.Line1(), tle.Line2(), RunTle( tle, start, end, inc, false ) } );
+   } );
+   if ( !read )
+   {
+      return false;
+   }
+
+   std::ofstream file( outfile, std::ios::binary );
+   if ( !file.is_open() )
+   {
+      std::cerr << "Error opening " << outfile << std::endl;
+      return false;
+   }
+
+   char header[8];
+   std::memcpy( header, "SREF", 4 );
+   PutUint32( header + 4, static_cast<uint32_t>( cases.size() ) );
+   file.write( header, sizeof( header ) );
+
+   size_t total = 0;
+   for ( const auto& test_case : cases )
+   {
+      const size_t length = libsgp4::Tle::LineLength();
+      char lines[2 * 69 + 4];
+      std::memcpy( lines, test_case.line1.data(), length );
+      std::memcpy( lines + length, test_case.line2.data(), length );
+      PutUint32( lines + 2 * length, static_cast<uint32_t>( test_case.samples.size() ) );
+      file.write( lines, sizeof( lines ) );
+
+      for ( const auto& sample : test_case.samples )
+      {
+         char record[kSampleBytes];
+         const double values[7] = { sample.tsince,
+                                    sample.position.x, sample.position.y, sample.position.z,
+                                    sample.velocity.x, sample.velocity.y, sample.velocity.z
+                                  };
+         for ( size_t i = 0; i < 7; i++ )
+         {
+            PutDouble( record + 8 * i, values[i] );
+         }
+         file.write( record, sizeof( record ) );
+      }
+      total += test_case.samples.size();
+   }
+
+   if ( !file )
+   {
+      std::cerr << "Error writing " << outfile << std::endl;
+      return false;
+   }
+
+   std::cout << "Wrote " << total << " samples of " << cases.size()
+             << " tles to " << outfile << std::endl;
+   return true;
+}
+
+bool ReadReference( const char* infile, std::vector<ReferenceCase>& cases )
+{
+   std::ifstream file( infile, std::ios::binary );
+   if ( !file.is_open() )
+   {
+      std::cerr << "Error opening " << infile << std::endl;
+      return false;
+   }
+
+   char header[8];
+   if ( !file.read( header, sizeof( header ) ) || std::memcmp( header, "SREF", 4 ) != 0 )
+   {
+      std::cerr << "Not a reference file: " << infile << std::endl;
+      return false;
+   }
+
+   const uint32_t count = GetUint32( header + 4 );
+   for ( uint32_t c = 0; c < count; c++ )
+   {
+      const size_t length = libsgp4::Tle::LineLength();
+      char lines[2 * 69 + 4];
+      if ( !file.read( lines, sizeof( lines ) ) )
+      {
+         std::cerr << "Truncated reference file: " << infile << std::endl;
+         return false;
+      }
+
+      ReferenceCase test_case;
+      test_case.line1.assign( lines, length );
+      test_case.line2.assign( lines + length, length );
+      test_case.samples.resize( GetUint32( lines + 2 * length ) );
+      for ( auto& sample : test_case.samples )
+      {
+         char record[kSampleBytes];
+         if ( !file.read( record, sizeof( record ) ) )
+         {
+            std::cerr << "Truncated reference file: " << infile << std::endl;
+            return false;
+         }
+         sample.tsince = GetDouble( record );
+         sample.position = libsgp4::Vector( GetDouble( record + 8 ),
+                                            GetDouble( record + 16 ),
+                                            GetDouble( record + 24 ) );
+         sample.velocity = libsgp4::Vector( GetDouble( record + 32 ),
+                                            GetDouble( record + 40 ),
+                                            GetDouble( record + 48 ) );
+         sample.valid = true;
+      }
+      cases.push_back( test_case );
+   }
+
+   return true;
+}
+
+/*
+ * A propagation mode fills one sample per time, in the order given. The
+ * times are in minutes since epoch and ascending.
+ */
+typedef void ( *Propagate )( const libsgp4::SGP4& sgp4,
+                             const std::vector<double>& times,
+                             std::vector<Sample>& samples );
+
+struct Mode
+{
+   const char* name;
+   Propagate propagate;
+};
+
+/*
+ * one call of SGP4::Propagate per sample
+ */
+void PropagateScalar( const libsgp4::SGP4& sgp4,
+                      const std::vector<double>& times,
+                      std::vector<Sample>& samples )
+{
+   samples.resize( times.size() );
+   for ( size_t i = 0; i < times.size(); i++ )
+   {
+      libsgp4::Vector3 position;
+      libsgp4::Vector3 velocity;
+      const libsgp4::PropagationStatus status = sgp4.Propagate( times[i], position, velocity );
+
+      Sample& sample = samples[i];
+      sample.tsince = times[i];
+      sample.position = position.ToVector();
+      sample.velocity = velocity.ToVector();
+      sample.valid = status == libsgp4::PropagationStatus::OK
+                     || status == libsgp4::PropagationStatus::DECAYED;
+   }
+}
+
+/*
+ * SGP4::FindPositions over the whole case
+ */
+void PropagateBatch( const libsgp4::SGP4& sgp4,
+                     const std::vector<double>& times,
+                     std::vector<Sample>& samples )
+{
+   libsgp4::PositionBuffer buffer;
+   sgp4.FindPositions( times.data(), times.size(), buffer );
+
+   samples.resize( times.size() );
+   for ( size_t i = 0; i < times.size(); i++ )
+   {
+      const libsgp4::PropagationStatus status = buffer.Status( i );
+      samples[i].tsince = times[i];
+      samples[i].position = buffer.Position( i ).ToVector();
+      samples[i].velocity = buffer.Velocity( i ).ToVector();
+      samples[i].valid = status == libsgp4::PropagationStatus::OK
+                         || status == libsgp4::PropagationStatus::DECAYED;
+   }
+}
+
+/*
+ * SGP4::PropagateFloat, widened back to double for the comparison
+ */
+void PropagateFloat( const libsgp4::SGP4& sgp4,
+                     const std::vector<double>& times,
+                     std::vector<Sample>& samples )
+{
+   samples.resize( times.size() );
+   for ( size_t i = 0; i < times.size(); i++ )
+   {
+      libsgp4::FloatStateVector state = {};
+      const libsgp4::PropagationStatus status = sgp4.PropagateFloat( times[i], state );
+
+      Sample& sample = samples[i];
+      sample.tsince = times[i];
+      sample.position = libsgp4::Vector( state.position[0], state.position[1], state.position[2] );
+      sample.velocity = libsgp4::Vector( state.velocity[0], state.velocity[1], state.velocity[2] );
+      sample.valid = status == libsgp4::PropagationStatus::OK
+                     || status == libsgp4::PropagationStatus::DECAYED;
+   }
+}
+
+/*
+ * cubic Hermite interpolation between nodes kNodeStep apart, using the
+ * velocity as the derivative of the position. The nodes sit half a step
+ * off whole minutes, so the reference samples fall mid segment, where the
+ * interpolation error is largest.
+ */
+void PropagateInterpolated( const libsgp4::SGP4& sgp4,
+                            const std::vector<double>& times,
+                            std::vector<Sample>& samples )
+{
+   samples.resize( times.size() );
+
+   Sample nodes[2] = {};
+   double first_node = NAN;
+   for ( size_t i = 0; i < times.size(); i++ )
+   {
+      Sample& sample = samples[i];
+      sample.tsince = times[i];
+
+      const double node = ( std::floor( times[i] / kNodeStep - 0.5 ) + 0.5 ) * kNodeStep;
+      if ( node != first_node )
+      {
+         std::vector<double> node_times;
+         if ( node == first_node + kNodeStep && nodes[1].valid )
+         {
+            nodes[0] = nodes[1];
+            node_times.push_back( node + kNodeStep );
+         }
+         else
+         {
+            node_times.push_back( node );
+            node_times.push_back( node + kNodeStep );
+         }
+
+         std::vector<Sample> propagated;
+         PropagateScalar( sgp4, node_times, propagated );
+         if ( propagated.size() == 2 )
+         {
+            nodes[0] = propagated[0];
+         }
+         nodes[1] = propagated.back();
+         first_node = node;
+      }
+
+      sample.valid = nodes[0].valid && nodes[1].valid;
+      if ( !sample.valid )
+      {
+         continue;
+      }
+
+      /*
+       * Hermite basis over the unit segment; velocities scaled to km per
+       * segment
+       */
+      const double h = kNodeStep * 60.0;
+      const double t = ( times[i] - node ) / kNodeStep;
+      const double t2 = t * t;
+      const double t3 = t2 * t;
+      const double h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+      const double h10 = t3 - 2.0 * t2 + t;
+      const double h01 = -2.0 * t3 + 3.0 * t2;
+      const double h11 = t3 - t2;
+      const double d00 = 6.0 * t2 - 6.0 * t;
+      const double d10 = 3.0 * t2 - 4.0 * t + 1.0;
+      const double d01 = -6.0 * t2 + 6.0 * t;
+      const double d11 = 3.0 * t2 - 2.0 * t;
+
+      const libsgp4::Vector& p0 = nodes[0].position;
+      const libsgp4::Vector& p1 = nodes[1].position;
+      const libsgp4::Vector& v0 = nodes[0].velocity;
+      const libsgp4::Vector& v1 = nodes[1].velocity;
+      sample.position = libsgp4::Vector(
+                           h00 * p0.x + h10 * h * v0.x + h01 * p1.x + h11 * h * v1.x,
+                           h00 * p0.y + h10 * h * v0.y + h01 * p1.y + h11 * h * v1.y,
+                           h00 * p0.z + h10 * h * v0.z + h01 * p1.z + h11 * h * v1.z );
+      sample.velocity = libsgp4::Vector(
+                           ( d00 * p0.x + d01 * p1.x ) / h + d10 * v0.x + d11 * v1.x,
+                           ( d00 * p0.y + d01 * p1.y ) / h + d10 * v0.y + d11 * v1.y,
+                           ( d00 * p0.z + d01 * p1.z ) / h + d10 * v0.z + d11 * v1.z );
+   }
+}
+
+const Mode kModes[] =
+{
+   { "scalar", PropagateScalar },
+   { "batch", PropagateBatch },
+   { "interpolated", PropagateInterpolated },
+   { "float", PropagateFloat },
+};
+
+/*
+ * Compare every mode against the reference samples and time it over a
+ * dense grid spanning each tles reference samples. Position errors are
+ * reported in metres and velocity errors in mm/s.
+ */
+bool Compare( const char* infile, const int repetitions )
+{
+   std::vector<ReferenceCase> cases;
+   if ( !ReadReference( infile, cases ) )
+   {
+      return false;
+   }
+
+   std::vector<libsgp4::SGP4> models;
+   std::vector<std::vector<double>> times;
+   std::vector<std::vector<double>> grids;
+   size_t reference_count = 0;
+   size_t grid_count = 0;
+   for ( const auto& test_case : cases )
+   {
+      models.emplace_back( libsgp4::Tle( "Test", test_case.line1, test_case.line2 ) );
+
+      std::vector<double> case_times;
+      for ( const auto& sample : test_case.samples )
+      {
+         case_times.push_back( sample.tsince );
+      }
+
+      /*
+       * the first reference sample is always at epoch, the rest run from
+       * the start of the case to its end
+       */
+      std::vector<double> grid;
+      if ( !case_times.empty() )
+      {
+         const double first = case_times.size() > 1 ? case_times[1] : case_times[0];
+         const double last = case_times.back();
+         for ( double t = first; t <= last; t += kThroughputStep )
+         {
+            grid.push_back( t );
+         }
+      }
+
+      reference_count += case_times.size();
+      grid_count += grid.size();
+      times.push_back( case_times );
+      grids.push_back( grid );
+   }
+
+   std::cout << "Reference: " << reference_count << " samples of "
+             << cases.size() << " tles; timing " << grid_count
+             << " samples " << repetitions << " times" << std::endl << std::endl;
+
+   std::cout << std::left << std::setw( 14 ) << "mode" << std::right
+             << std::setw( 8 ) << "failed"
+             << std::setw( 14 ) << "max pos m"
+             << std::setw( 14 ) << "rms pos m"
+             << std::setw( 14 ) << "max vel mm/s"
+             << std::setw( 14 ) << "rms vel mm/s"
+             << std::setw( 14 ) << "Msamples/s" << std::endl;
+
+   for ( const Mode& mode : kModes )
+   {
+      size_t failed = 0;
+      size_t compared = 0;
+      double max_position = 0.0;
+      double max_velocity = 0.0;
+      double sum_position = 0.0;
+      double sum_velocity = 0.0;
+
+      std::vector<Sample> samples;
+      for ( size_t c = 0; c < cases.size(); c++ )
+      {
+         mode.propagate( models[c], times[c], samples );
+         for ( size_t i = 0; i < samples.size(); i++ )
+         {
+            if ( !samples[i].valid )
+            {
+               failed++;
+               continue;
+            }
+            const Sample& reference = cases[c].samples[i];
+            const double position = ( samples[i].position - reference.position ).Magnitude() * 1e3;
+            const double velocity = ( samples[i].velocity - reference.velocity ).Magnitude() * 1e6;
+            max_position = std::max( max_position, position );
+            max_velocity = std::max( max_velocity, velocity );
+            sum_position += position * position;
+            sum_velocity += velocity * velocity;
+            compared++;
+         }
+      }
+
+      const auto begin = std::chrono::steady_clock::now();
+      for ( int r = 0; r < repetitions; r++ )
+      {
+         for ( size_t c = 0; c < cases.size(); c++ )
+         {
+            mode.propagate( models[c], grids[c], samples );
+         }
+      }
+      const double seconds = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - begin ).count();
+
+      const double n = static_cast<double>( std::max<size_t>( compared, 1 ) );
+      std::cout << std::left << std::setw( 14 ) << mode.name << std::right
+                << std::setw( 8 ) << failed
+                << std::setprecision( 6 ) << std::scientific
+                << std::setw( 14 ) << max_position
+                << std::setw( 14 ) << std::sqrt( sum_position / n )
+                << std::setw( 14 ) << max_velocity
+                << std::setw( 14 ) << std::sqrt( sum_velocity / n )
+                << std::setprecision( 3 ) << std::fixed
+                << std::setw( 14 )
+                << static_cast<double>( grid_count ) * repetitions / seconds / 1e6
+                << std::endl;
+   }
+
+   return true;
+}
+
+void Usage()
+{
+   std::cerr << "usage: runtest [--tle file]" << std::endl
+             << "       runtest [--tle file] --write-reference file" << std::endl
+             << "       runtest --compare file [--repetitions n]" << std::endl;
 }
 
-int main()
+int main( int argc, char* argv[] )
 {
    const char* file_name = "SGP4-VER.TLE";
+   const char* reference = nullptr;
+   const char* compare = nullptr;
+   int repetitions = 5;
+
+   for ( int i = 1; i < argc; i++ )
+   {
+      const std::string arg = argv[i];
+      if ( i + 1 >= argc )
+      {
+         Usage();
+         return EXIT_FAILURE;
+      }
+      if ( arg == "--tle" )
+      {
+         file_name = argv[++i];
+      }
+      else if ( arg == "--write-reference" )
+      {
+         reference = argv[++i];
+      }
+      else if ( arg == "--compare" )
+      {
+         compare = argv[++i];
+      }
+      else if ( arg == "--repetitions" )
+      {
+         repetitions = std::max( 1, atoi( argv[++i] ) );
+      }
+      else
+      {
+         Usage();
+         return EXIT_FAILURE;
+      }
+   }
 
-   RunTest( file_name );
+   if ( reference != nullptr )
+   {
+      return WriteReference( file_name, reference ) ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+
+   if ( compare != nullptr )
+   {
+      return Compare( compare, repetitions ) ? EXIT_SUCCESS : EXIT_FAILURE;
+   }
+
+   /*
+    * print the state vectors, for diffing against the published ones
+    */
+   RunTest( file_name, []( const libsgp4::Tle& tle, double start, double end, double inc )
+   {
+      RunTle( tle, start, end, inc, true );
+   } );
 
    return 1;
 }
@@ -0,0 +1,92 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <CoordGeodetic.h>
+#include <DateTime.h>
+#include <DopplerTable.h>
+#include <PassPredictor.h>
+#include <SGP4.h>
+
+#include "tle_file.h"
+
+// Writes the Doppler and delay table for the next pass of one craft, as the
+// ground modems consume it: uplink and downlink frequency corrections and
+// one-way light time at a fixed rate from AOS to LOS. Files ending in .csv
+// are written as text, anything else in the compact binary format described
+// in DopplerTable.h.
+
+// seconds between propagated nodes of the table
+static const int kCoarseStep = 10;
+
+static bool ends_with(const std::string &s, const std::string &suffix) {
+  return s.size() >= suffix.size() &&
+         s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char *argv[]) {
+  // usage: doppler_table [tle file] [craft index] [downlink MHz] [uplink MHz]
+  //                      [rate Hz] [output file]
+  std::string tle_filename = argc > 1 ? argv[1] : "mPOWER.tle";
+  size_t craft = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0;
+  double downlink = argc > 3 ? std::atof(argv[3]) : 17700.0;
+  double uplink = argc > 4 ? std::atof(argv[4]) : 27500.0;
+  double rate = argc > 5 ? std::atof(argv[5]) : 10.0;
+  std::string out_filename = argc > 6 ? argv[6] : "doppler.csv";
+
+  if (rate <= 0.0) {
+    std::cout << "Sample rate must be positive." << std::endl;
+    return -EXIT_FAILURE;
+  }
+
+  // lat/lon/altitude of PIE airport.
+  libsgp4::CoordGeodetic observer_GPS(27.9086, -82.6865, 3.0);
+
+  std::vector<std::string> tle_data{};
+  size_t craft_count = fetch_tle_data(tle_filename, tle_data);
+  if (craft >= craft_count) {
+    std::cout << "No craft (" << craft << ") in the TLE file." << std::endl;
+    return -EXIT_FAILURE;
+  }
+
+  libsgp4::Tle tle(tle_data.at(craft * 3), tle_data.at(craft * 3 + 1),
+                   tle_data.at(craft * 3 + 2));
+  libsgp4::SGP4 sgp4(tle);
+
+  libsgp4::PassPredictor predictor(observer_GPS, sgp4);
+  libsgp4::DateTime now = libsgp4::DateTime::Now(true);
+  std::list<libsgp4::PassDetails> passes =
+      predictor.GeneratePassList(now, now.AddDays(1.0), 60);
+  if (passes.empty()) {
+    std::cout << "No pass of " << tle.Name() << " within a day." << std::endl;
+    return 0;
+  }
+  const libsgp4::PassDetails pass = passes.front();
+
+  libsgp4::DopplerTable table(observer_GPS, sgp4, downlink * 1e6,
+                              uplink * 1e6);
+  libsgp4::PropagationStatus status =
+      table.Prepare(pass.aos, pass.los, kCoarseStep);
+  if (status != libsgp4::PropagationStatus::OK) {
+    std::cout << "Cannot propagate " << tle.Name() << ": "
+              << libsgp4::ToString(status) << std::endl;
+    return -EXIT_FAILURE;
+  }
+
+  size_t count;
+  if (ends_with(out_filename, ".csv")) {
+    std::ofstream ofs(out_filename);
+    count = table.WriteCsv(ofs, rate);
+  } else {
+    std::ofstream ofs(out_filename, std::ios::binary);
+    count = table.WriteBinary(ofs, rate);
+  }
+
+  std::cout << "CRAFT: (" << tle.Name() << ") AOS " << pass.aos << " LOS "
+            << pass.los << ", " << count << " samples to " << out_filename
+            << std::endl;
+  return 0;
+}
@@ -11,6 +11,8 @@
 #include <SGP4.h>
 #include <TimeSpan.h>
 
+#include "tle_file.h"
+
 struct look_angle_data_t {
   uint64_t m_current_tick;
   double m_az;
@@ -19,31 +21,6 @@ struct look_angle_data_t {
   double m_range_rate;
 };
 
-static size_t fetch_tle_data(const std::string &tle_filename,
-                             std::vector<std::string> &tle_data) {
-
-  std::ifstream infile(tle_filename);
-  size_t found_craft_count{0};
-
-  if (false == infile.is_open()) {
-    std::cout << "Failed to open TLE File." << std::endl;
-    return 0;
-  }
-
-  std::string line;
-  while (std::getline(infile, line)) {
-    tle_data.push_back(line);
-    found_craft_count++;
-  }
-  // divide by three as three lines of text define each craft in a TLE file...
-  // (Three-Line-Element? I know, it's referred to as a TWO Line Element
-  // file...)
-  found_craft_count = found_craft_count / 3;
-
-  infile.close();
-  return found_craft_count;
-}
-
 static void
 generate_track_data(const std::vector<std::string> &discovered_craft,
                     const libsgp4::CoordGeodetic &observer_GPS, int index) {
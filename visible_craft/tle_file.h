@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Read a TLE file into tle_data, one entry per line. Returns the number of
+// craft in the file, or 0 if it cannot be opened.
+inline size_t fetch_tle_data(const std::string &tle_filename,
+                             std::vector<std::string> &tle_data) {
+
+  std::ifstream infile(tle_filename);
+  size_t found_craft_count{0};
+
+  if (false == infile.is_open()) {
+    std::cout << "Failed to open TLE File." << std::endl;
+    return 0;
+  }
+
+  std::string line;
+  while (std::getline(infile, line)) {
+    tle_data.push_back(line);
+    found_craft_count++;
+  }
+  // divide-by-3 as each craft (better have!) three lines of
+  // details in the TLE file.
+  found_craft_count = found_craft_count / 3;
+
+  infile.close();
+  return found_craft_count;
+}
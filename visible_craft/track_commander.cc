@@ -0,0 +1,147 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <CoordGeodetic.h>
+#include <DateTime.h>
+#include <PassPredictor.h>
+#include <PointingCommand.h>
+#include <SGP4.h>
+#include <SpscRingBuffer.h>
+#include <TrackPlanner.h>
+#include <TrajectoryGenerator.h>
+#include <Util.h>
+
+#include "tle_file.h"
+
+// Streams pointing commands for the next pass of one craft to a stand-in
+// control loop. A producer thread propagates and interpolates the pass into
+// a ring buffer; the control loop only pops ready commands, at the command
+// rate, and never waits on propagation. The pass is replayed from AOS
+// starting immediately, rather than waiting for it to rise. The commands are
+// planned for the mount (cable wrap, keyhole) before they are queued.
+
+// seconds between propagated nodes of the trajectory
+static const int kCoarseStep = 10;
+// commands buffered ahead of the control loop
+static const size_t kRingCapacity = 1024;
+
+int main(int argc, char *argv[]) {
+  // usage: track_commander [tle file] [craft index] [rate Hz] [run seconds]
+  //                        [mount: azel | flip | xy]
+  std::string tle_filename = argc > 1 ? argv[1] : "mPOWER.tle";
+  size_t craft = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 0;
+  double rate = argc > 3 ? std::atof(argv[3]) : 50.0;
+  double run_time = argc > 4 ? std::atof(argv[4]) : 10.0;
+  std::string mount = argc > 5 ? argv[5] : "azel";
+
+  libsgp4::MountLimits limits;
+  if (mount == "flip") {
+    limits.type = libsgp4::MountType::AZ_EL_FLIP;
+  } else if (mount == "xy") {
+    limits.type = libsgp4::MountType::X_Y;
+  } else if (mount != "azel") {
+    std::cout << "Unknown mount (" << mount << ")." << std::endl;
+    return -EXIT_FAILURE;
+  }
+
+  if (rate < 10.0 || rate > 100.0) {
+    std::cout << "Command rate must be between 10 and 100 Hz." << std::endl;
+    return -EXIT_FAILURE;
+  }
+
+  // lat/lon/altitude of PIE airport.
+  libsgp4::CoordGeodetic observer_GPS(27.9086, -82.6865, 3.0);
+
+  std::vector<std::string> tle_data{};
+  size_t craft_count = fetch_tle_data(tle_filename, tle_data);
+  if (craft >= craft_count) {
+    std::cout << "No craft (" << craft << ") in the TLE file." << std::endl;
+    return -EXIT_FAILURE;
+  }
+
+  libsgp4::Tle tle(tle_data.at(craft * 3), tle_data.at(craft * 3 + 1),
+                   tle_data.at(craft * 3 + 2));
+  libsgp4::SGP4 sgp4(tle);
+
+  libsgp4::PassPredictor predictor(observer_GPS, sgp4);
+  libsgp4::DateTime now = libsgp4::DateTime::Now(true);
+  std::list<libsgp4::PassDetails> passes =
+      predictor.GeneratePassList(now, now.AddDays(1.0), 60);
+  if (passes.empty()) {
+    std::cout << "No pass of " << tle.Name() << " within a day." << std::endl;
+    return 0;
+  }
+  const libsgp4::PassDetails pass = passes.front();
+  std::cout << "CRAFT: (" << tle.Name() << ") AOS " << pass.aos << " LOS "
+            << pass.los << std::endl;
+
+  libsgp4::SpscRingBuffer<libsgp4::PointingCommand> ring(kRingCapacity);
+  std::atomic<bool> stop{false};
+
+  std::thread producer([&]() {
+    libsgp4::TrajectoryGenerator generator(observer_GPS, sgp4);
+    libsgp4::PropagationStatus status =
+        generator.Prepare(pass.aos, pass.los, kCoarseStep);
+    if (status != libsgp4::PropagationStatus::OK) {
+      std::cout << "Cannot propagate " << tle.Name() << ": "
+                << libsgp4::ToString(status) << std::endl;
+      return;
+    }
+
+    std::vector<libsgp4::PointingCommand> commands;
+    generator.Generate(rate, commands);
+    libsgp4::TrackPlan plan = libsgp4::TrackPlanner(limits).Plan(commands);
+    std::cout << "Plan: keyhole " << plan.keyhole << ", flipped "
+              << plan.flipped << ", within limits " << plan.within_limits
+              << std::endl;
+
+    libsgp4::TrajectoryGenerator::Produce(commands, ring, stop);
+  });
+
+  std::string ofilename{tle.Name()};
+  std::replace(ofilename.begin(), ofilename.end(), ' ', '_');
+  ofilename += ".commands";
+  std::ofstream ofs(ofilename);
+
+  const auto period = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::duration<double>(1.0 / rate));
+  const auto ticks = static_cast<long>(run_time * rate);
+  size_t issued{0};
+  size_t underruns{0};
+  auto wake = std::chrono::steady_clock::now();
+
+  for (long i = 0; i < ticks; ++i) {
+    wake += period;
+    std::this_thread::sleep_until(wake);
+
+    libsgp4::PointingCommand command;
+    if (!ring.TryPop(command)) {
+      // nothing ready: hold the previous command rather than wait
+      underruns++;
+      continue;
+    }
+    issued++;
+    if (ofs) {
+      ofs << command.ticks - libsgp4::UnixEpoch << ","
+          << libsgp4::Util::RadiansToDegrees(command.azimuth) << ","
+          << libsgp4::Util::RadiansToDegrees(command.elevation) << ","
+          << libsgp4::Util::RadiansToDegrees(command.azimuth_rate) << ","
+          << libsgp4::Util::RadiansToDegrees(command.elevation_rate) << "\n";
+    }
+  }
+
+  stop = true;
+  producer.join();
+
+  std::cout << "Issued " << issued << " commands at " << rate << " Hz, "
+            << underruns << " ticks with no command ready." << std::endl;
+  return 0;
+}
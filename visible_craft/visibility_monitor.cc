@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <CoordGeodetic.h>
+#include <CoordTopocentric.h>
+#include <DateTime.h>
+#include <Eci.h>
+#include <Observer.h>
+#include <PassPredictor.h>
+#include <PropagationStatus.h>
+#include <SGP4.h>
+#include <TimeSpan.h>
+
+#include "tle_file.h"
+
+// Long-running monitor: keeps a propagator per craft resident, predicts the
+// next rise/culmination/set of every craft, and sleeps until the earliest of
+// them. Work is done per event, not per craft per tick.
+
+enum class EventType { RISE, CULMINATION, SET, RESCHEDULE };
+
+struct craft_event_t {
+  libsgp4::DateTime m_time;
+  size_t m_craft;
+  EventType m_type;
+};
+
+struct later_event {
+  bool operator()(const craft_event_t &a, const craft_event_t &b) const {
+    return a.m_time > b.m_time;
+  }
+};
+
+using event_queue_t = std::priority_queue<craft_event_t,
+                                          std::vector<craft_event_t>,
+                                          later_event>;
+
+// how far ahead to search for the next pass of a craft
+static const double kLookaheadDays = 1.0;
+// coarse step of the pass search, in seconds
+static const int kSearchStep = 60;
+
+static std::chrono::system_clock::time_point
+to_time_point(const libsgp4::DateTime &dt) {
+  return std::chrono::system_clock::time_point(
+      std::chrono::microseconds(dt.Ticks() - libsgp4::UnixEpoch));
+}
+
+// Report a craft that can no longer be propagated, e.g. because it has
+// decayed; it is dropped from the monitor.
+static void report_dropped(const std::string &name, const char *reason) {
+  std::cout << "Dropping " << name << ": " << reason << std::endl;
+}
+
+// Search for the next pass of a craft starting at 'from' and queue its
+// events. If there is no pass within the lookahead, queue a reschedule at the
+// end of the lookahead instead. A pass cut off by the end of the lookahead has
+// no known set time, so it is carried over: the search is repeated from its
+// rise, or from the end of the lookahead if the craft is up for all of it.
+// Returns false if the craft cannot be propagated at 'from'; the pass search
+// takes such times to be below the horizon, so it would never find a pass.
+static bool schedule_next_pass(libsgp4::PassPredictor &predictor,
+                               const libsgp4::SGP4 &sgp4, size_t craft,
+                               const std::string &name,
+                               const libsgp4::DateTime &from,
+                               event_queue_t &events) {
+  libsgp4::Eci eci(from, libsgp4::Vector());
+  libsgp4::PropagationStatus status = sgp4.Propagate(from, eci);
+  if (status != libsgp4::PropagationStatus::OK) {
+    report_dropped(name, libsgp4::ToString(status));
+    return false;
+  }
+
+  libsgp4::DateTime until = from.AddDays(kLookaheadDays);
+  std::list<libsgp4::PassDetails> passes =
+      predictor.GeneratePassList(from, until, kSearchStep);
+
+  if (passes.empty()) {
+    events.push({until, craft, EventType::RESCHEDULE});
+    return true;
+  }
+
+  const libsgp4::PassDetails &pass = passes.front();
+  if (pass.los >= until) {
+    events.push({pass.aos > from ? pass.aos : until, craft,
+                 EventType::RESCHEDULE});
+    return true;
+  }
+
+  events.push({pass.aos, craft, EventType::RISE});
+  if (pass.max_elevation_time > pass.aos) {
+    events.push({pass.max_elevation_time, craft, EventType::CULMINATION});
+  }
+  events.push({pass.los, craft, EventType::SET});
+  return true;
+}
+
+// Print an event with the look angle of the craft at its time. Returns false
+// if the craft cannot be propagated.
+static bool emit_event(const craft_event_t &event, const std::string &name,
+                       const libsgp4::SGP4 &sgp4, libsgp4::Observer &obs) {
+  static const char *event_names[] = {"RISE", "CULMINATION", "SET"};
+
+  libsgp4::Eci eci(event.m_time, libsgp4::Vector());
+  libsgp4::PropagationStatus status = sgp4.Propagate(event.m_time, eci);
+  if (status != libsgp4::PropagationStatus::OK) {
+    report_dropped(name, libsgp4::ToString(status));
+    return false;
+  }
+  libsgp4::CoordTopocentric topo = obs.GetLookAngle(eci);
+
+  std::cout << event.m_time << " " << std::left << std::setw(12)
+            << event_names[static_cast<int>(event.m_type)] << name
+            << ": AZ(" << topo.azimuth() << "), EL(" << topo.elevation()
+            << ")" << std::endl;
+  return true;
+}
+
+int main(int argc, char *argv[]) {
+  // usage: visibility_monitor [tle file] [tick rate Hz] [run time seconds]
+  std::string tle_filename = argc > 1 ? argv[1] : "mPOWER.tle";
+  double tick_rate = argc > 2 ? std::atof(argv[2]) : 1.0;
+  double run_time = argc > 3 ? std::atof(argv[3]) : 0.0;
+
+  if (tick_rate <= 0.0) {
+    std::cout << "Tick rate must be positive." << std::endl;
+    return -EXIT_FAILURE;
+  }
+
+  // lat/lon/altitude of PIE airport.
+  libsgp4::CoordGeodetic observer_GPS(27.9086, -82.6865, 3.0);
+  libsgp4::Observer obs(observer_GPS);
+
+  std::vector<std::string> tle_data{};
+  size_t craft_count = fetch_tle_data(tle_filename, tle_data);
+  if (craft_count == 0) {
+    return -EXIT_FAILURE;
+  }
+  std::cout << "Monitoring (" << craft_count << ") craft at " << tick_rate
+            << " Hz..." << std::endl;
+
+  // every propagator stays resident for the life of the monitor; the
+  // predictors hold references, so the vector must not grow afterwards.
+  std::vector<std::string> names;
+  std::vector<libsgp4::SGP4> propagators;
+  names.reserve(craft_count);
+  propagators.reserve(craft_count);
+  for (size_t i = 0; i < craft_count; ++i) {
+    libsgp4::Tle tle(tle_data.at(i * 3), tle_data.at(i * 3 + 1),
+                     tle_data.at(i * 3 + 2));
+    names.push_back(tle.Name());
+    propagators.emplace_back(tle);
+  }
+
+  std::vector<libsgp4::PassPredictor> predictors;
+  predictors.reserve(craft_count);
+  for (const auto &sgp4 : propagators) {
+    predictors.emplace_back(observer_GPS, sgp4);
+  }
+
+  libsgp4::DateTime start = libsgp4::DateTime::Now(true);
+  libsgp4::DateTime stop = start.AddSeconds(run_time);
+
+  // craft that can no longer be propagated; their queued events are ignored
+  std::vector<bool> dropped(craft_count, false);
+
+  event_queue_t events;
+  for (size_t i = 0; i < craft_count; ++i) {
+    dropped[i] = !schedule_next_pass(predictors[i], propagators[i], i,
+                                     names[i], start, events);
+  }
+
+  const auto tick = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::duration<double>(1.0 / tick_rate));
+
+  while (!events.empty()) {
+    libsgp4::DateTime now = libsgp4::DateTime::Now(true);
+    if (run_time > 0.0 && now >= stop) {
+      break;
+    }
+
+    // handle every event that has become due since the last wake-up
+    while (!events.empty() && events.top().m_time <= now) {
+      craft_event_t event = events.top();
+      events.pop();
+
+      const size_t craft = event.m_craft;
+      if (dropped[craft]) {
+        continue;
+      }
+
+      if (event.m_type == EventType::RESCHEDULE) {
+        dropped[craft] = !schedule_next_pass(predictors[craft],
+                                             propagators[craft], craft,
+                                             names[craft], event.m_time,
+                                             events);
+        continue;
+      }
+
+      if (!emit_event(event, names[craft], propagators[craft], obs)) {
+        dropped[craft] = true;
+        continue;
+      }
+
+      if (event.m_type == EventType::SET) {
+        // start looking for the next pass just after this one ends
+        dropped[craft] = !schedule_next_pass(
+            predictors[craft], propagators[craft], craft, names[craft],
+            event.m_time.AddSeconds(kSearchStep), events);
+      }
+    }
+
+    if (events.empty()) {
+      break;
+    }
+
+    // sleep until the next event, rounded up to the tick grid
+    auto wake = to_time_point(events.top().m_time);
+    if (run_time > 0.0) {
+      wake = std::min(wake, to_time_point(stop));
+    }
+    auto since_epoch = wake.time_since_epoch();
+    auto ticks = (since_epoch + tick - std::chrono::microseconds(1)) / tick;
+    std::this_thread::sleep_until(
+        std::chrono::system_clock::time_point(ticks * tick));
+  }
+
+  return 0;
+}
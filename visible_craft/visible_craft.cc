@@ -1,5 +1,4 @@
 #include <array>
-#include <fstream>
 #include <iostream>
 #include <string>
 #include <vector>
@@ -11,29 +10,7 @@
 #include <SGP4.h>
 #include <TimeSpan.h>
 
-static size_t fetch_tle_data(const std::string &tle_filename,
-                             std::vector<std::string> &tle_data) {
-
-  std::ifstream infile(tle_filename);
-  size_t found_craft_count{0};
-
-  if (false == infile.is_open()) {
-    std::cout << "Failed to open TLE File." << std::endl;
-    return 0;
-  }
-
-  std::string line;
-  while (std::getline(infile, line)) {
-    tle_data.push_back(line);
-    found_craft_count++;
-  }
-  // divide-by-3 as each craft (better have!) three lines of
-  // details in the TLE file.
-  found_craft_count = found_craft_count / 3;
-
-  infile.close();
-  return found_craft_count;
-}
+#include "tle_file.h"
 
 static bool fetch_tle_triplet(int index,
                               std::array<std::string, 3> &tle_triplet,